@@ -0,0 +1,71 @@
+#include "allocation_tracking.hpp"
+
+#include <mutex>
+#include <new>
+
+namespace
+{
+    std::mutex statistics_mutex;
+    AllocationTracking::Statistics current_statistics;
+
+    /// The bytes of a storage of `shape` and `size` bytes that hold neither the header nor the elements.
+    [[nodiscard]] auto padding_bytes(const AllocationTracking::StorageShape& shape, const size_t size) noexcept -> Int
+    {
+        return static_cast<Int>(size - shape.header_size) - (static_cast<Int>(shape.element_size) * shape.capacity);
+    }
+} // namespace
+
+namespace AllocationTracking
+{
+    void record_allocation(const StorageShape& shape, const size_t size) noexcept
+    {
+        const std::scoped_lock lock{statistics_mutex};
+        current_statistics.live_bytes += static_cast<Int>(size);
+        current_statistics.peak_bytes = std::max(current_statistics.peak_bytes, current_statistics.live_bytes);
+        current_statistics.live_padding_bytes += padding_bytes(shape, size);
+        ++current_statistics.allocation_count;
+        try
+        {
+            ++current_statistics.allocations_per_shape[shape];
+        }
+        catch (const std::bad_alloc&)
+        {
+            // A new shape needs a map node. Without memory for it, the allocation is recorded in the totals only.
+        }
+    }
+
+    void record_deallocation(const StorageShape& shape, const size_t size) noexcept
+    {
+        const std::scoped_lock lock{statistics_mutex};
+        current_statistics.live_bytes -= static_cast<Int>(size);
+        current_statistics.live_padding_bytes -= padding_bytes(shape, size);
+        ++current_statistics.deallocation_count;
+    }
+
+    void record_temporary(const size_t size, const TemporaryPlacement placement) noexcept
+    {
+        const std::scoped_lock lock{statistics_mutex};
+        ++current_statistics.temporary_count;
+        if (placement == TemporaryPlacement::heap)
+        {
+            ++current_statistics.heap_temporary_count;
+        }
+        else if (placement == TemporaryPlacement::scratch_arena)
+        {
+            ++current_statistics.scratch_temporary_count;
+        }
+        current_statistics.temporary_bytes += static_cast<Int>(size);
+    }
+
+    auto statistics() -> Statistics
+    {
+        const std::scoped_lock lock{statistics_mutex};
+        return current_statistics;
+    }
+
+    void reset() noexcept
+    {
+        const std::scoped_lock lock{statistics_mutex};
+        current_statistics = Statistics{};
+    }
+} // namespace AllocationTracking
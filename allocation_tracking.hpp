@@ -0,0 +1,90 @@
+#ifndef CPP_MVS_ALLOCATION_TRACKING_HPP
+#define CPP_MVS_ALLOCATION_TRACKING_HPP
+
+#include <compare>
+#include <map>
+#include "library.h"
+
+/// Whether flexible arrays record their allocations, set by defining `CPP_MVS_TRACK_ALLOCATIONS`.
+///
+/// When disabled, the recording calls are discarded at compile time, so that tracking costs nothing.
+#ifdef CPP_MVS_TRACK_ALLOCATIONS
+inline constexpr bool allocation_tracking_enabled = true;
+#else
+inline constexpr bool allocation_tracking_enabled = false;
+#endif
+
+namespace AllocationTracking
+{
+    /// Where a projected temporary is placed.
+    enum class TemporaryPlacement
+    {
+        stack,
+        heap,
+        scratch_arena,
+    };
+
+    /// The shape of a flexible array storage, grouping allocations in the statistics.
+    struct StorageShape
+    {
+        size_t header_size;
+        size_t element_size;
+        Int capacity;
+
+        auto operator<=>(const StorageShape& other) const = default;
+    };
+
+    /// The allocations recorded since the program start or the last `reset()`.
+    struct Statistics
+    {
+        /// The bytes of heap storage currently allocated.
+        Int live_bytes = 0;
+
+        /// The maximum of `live_bytes` ever reached.
+        Int peak_bytes = 0;
+
+        /// The bytes of the currently allocated heap storage spent on alignment padding rather than on the header
+        /// or the elements.
+        Int live_padding_bytes = 0;
+
+        /// The number of heap storages allocated, counting a resized storage as a new allocation.
+        Int allocation_count = 0;
+
+        /// The number of heap storages freed, counting a resized storage as a freed one.
+        Int deallocation_count = 0;
+
+        /// The number of heap storages allocated per shape.
+        ///
+        /// Misses the allocations of a new shape when there is no memory left to record it.
+        std::map<StorageShape, Int> allocations_per_shape;
+
+        /// The number of projected temporaries.
+        Int temporary_count = 0;
+
+        /// The number of projected temporaries that exceeded the stack budget and went to the heap.
+        Int heap_temporary_count = 0;
+
+        /// The number of temporaries projected onto the scratch arena.
+        Int scratch_temporary_count = 0;
+
+        /// The bytes of storage used by the projected temporaries altogether.
+        Int temporary_bytes = 0;
+    };
+
+    /// Records the allocation of a heap storage of `shape`, taking `size` bytes.
+    void record_allocation(const StorageShape& shape, size_t size) noexcept;
+
+    /// Records freeing a heap storage of `shape`, which took `size` bytes.
+    void record_deallocation(const StorageShape& shape, size_t size) noexcept;
+
+    /// Records projecting a temporary onto `size` bytes of storage at `placement`.
+    void record_temporary(size_t size, TemporaryPlacement placement) noexcept;
+
+    /// A snapshot of the statistics.
+    [[nodiscard]] auto statistics() -> Statistics;
+
+    /// Clears the statistics.
+    void reset() noexcept;
+} // namespace AllocationTracking
+
+#endif // CPP_MVS_ALLOCATION_TRACKING_HPP
@@ -1,9 +1,31 @@
+#ifndef CPP_MVS_ARRAY_HPP
+#define CPP_MVS_ARRAY_HPP
+
+#include <algorithm>
 #include <concepts>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <span>
+#include "bulk_algorithms.hpp"
 #include "flexible_array_checked.hpp"
 #include "library.h"
+#include "reference_counter.hpp"
 
 
-template <typename Element>
+/// A growable array whose count and capacity live in the heap-allocated storage, acquired from `Allocator`.
+///
+/// An empty array holds no storage, so that it is a single null pointer and checking for emptiness reads no memory.
+/// Arrays give up their storage whenever their count drops to zero.
+///
+/// Arrays of copyable elements have value semantics: copies share the storage, counting the references to it in
+/// its header with `Counter`, and the elements are copied lazily by the first mutation of a shared array. Arrays
+/// sharing storage across threads need a thread-safe counter, such as AtomicReferenceCounter.
+///
+/// Handing out a mutable reference, pointer or span to the elements marks the storage unshareable, as writes through
+/// it must not show in later copies: copies of such an array copy the elements eagerly.
+template <typename Element, StorageAllocator Allocator = DefaultAllocator,
+          ReferenceCounter Counter = NonAtomicReferenceCounter>
     requires std::movable<Element> && std::destructible<Element>
 class Array
 {
@@ -12,6 +34,16 @@ class Array
         Int count;
         Int capacity;
 
+        /// The number of arrays sharing the storage.
+        ///
+        /// Mutable, so that copying from a const array can share its storage.
+        mutable Counter reference_count;
+
+        /// Whether a mutable reference to the elements was handed out, so that copies may not share the storage.
+        ///
+        /// Stays set until the storage is replaced.
+        bool unshareable = false;
+
         [[nodiscard]] explicit Header(const Int count, const Int capacity) noexcept : count(count), capacity(capacity)
         {
         }
@@ -23,32 +55,300 @@ class Array
     };
     static_assert(TrailingElementCountProvider<Header>);
 
+    using Storage = FlexibleArrayChecked<Header, Element, Allocator>;
+
+    /// Whether copying the elements, as unsharing a shared storage does, cannot throw.
+    static constexpr bool nothrow_unshare =
+        !std::copy_constructible<Element> || std::is_nothrow_copy_constructible_v<Element>;
+
+    /// Whether moving the elements to a new storage cannot throw.
+    ///
+    /// Elements whose move constructor may throw are copied instead when they are copyable, as with
+    /// `std::move_if_noexcept`, so that a throwing copy leaves the old storage untouched.
+    static constexpr bool nothrow_relocation =
+        is_trivially_relocatable_v<Element> ||
+        std::is_nothrow_constructible_v<Element, decltype(std::move_if_noexcept(std::declval<Element&>()))>;
+
+    /// The capacity of the first heap allocation made by a growing append.
+    static constexpr Int minimum_grown_capacity = 4;
+
     /// The underlying storage for the array.
     ///
-    /// May be invalid while the capacity is zero.
-    FlexibleArrayChecked<Header, Element> storage;
+    /// Invalid if and only if the array is empty.
+    Storage storage;
 
     /// Constructs the Array with given storage.
-    [[nodiscard]] explicit Array(FlexibleArrayChecked<Header, Element>&& storage) noexcept : storage(std::move(storage))
+    [[nodiscard]] explicit Array(Storage&& storage) noexcept : storage(std::move(storage)) {}
+
+    /// The capacity to grow to so that at least `minimum_capacity` elements fit, growing geometrically.
+    [[nodiscard]] constexpr auto grown_capacity(const Int minimum_capacity) const noexcept -> Int
+    {
+        return std::max({minimum_capacity, capacity() * 2, minimum_grown_capacity});
+    }
+
+    /// Returns a new reference to the storage of this array.
+    [[nodiscard]] auto share_storage() const noexcept -> Storage
+    {
+        if (!storage.is_valid())
+        {
+            return Storage::create_empty();
+        }
+        storage.header()->reference_count.retain();
+        return Storage::adopting_storage(storage.storage_address());
+    }
+
+    /// Destroys the `count` elements from `first` when destroyed, unless dismissed by clearing `first` first.
+    ///
+    /// Destroys the elements constructed so far in a new storage when constructing the next one throws, while the
+    /// storage frees its own memory.
+    struct ConstructedElements
+    {
+        Element* first;
+        Int count = 0;
+
+        ~ConstructedElements()
+        {
+            if (first != nullptr)
+            {
+                std::destroy_n(first, count);
+            }
+        }
+    };
+
+    /// Returns a new storage with space for `new_capacity` elements, holding copies of the elements of this array.
+    ///
+    /// Requires the storage to be valid and `new_capacity >= count()`.
+    [[nodiscard]] auto copy_storage(const Int new_capacity) const
+        noexcept(std::is_nothrow_copy_constructible_v<Element>) -> Storage
+        requires std::copy_constructible<Element>
+    {
+        const Int element_count = count();
+        auto new_storage = Storage::with_header(new_capacity, Header{0, new_capacity});
+        ConstructedElements copies{new_storage.element_address(0)};
+        for (; copies.count < element_count; ++copies.count)
+        {
+            std::construct_at(new_storage.element_address(copies.count),
+                              std::as_const(*storage.element_address(copies.count)));
+        }
+        copies.first = nullptr;
+        new_storage.header()->count = element_count;
+        return new_storage;
+    }
+
+    /// Returns the storage for a copy of this array: shared, unless a mutable reference into it was handed out.
+    [[nodiscard]] auto storage_for_copy() const noexcept(std::is_nothrow_copy_constructible_v<Element>) -> Storage
+        requires std::copy_constructible<Element>
+    {
+        if (storage.is_valid() && storage.header()->unshareable)
+        {
+            return copy_storage(count());
+        }
+        return share_storage();
+    }
+
+    /// Gives up the reference to the storage, destroying the elements and the storage if it was the last one.
+    ///
+    /// Leaves the storage invalid.
+    void release_storage() noexcept
+    {
+        if (!storage.is_valid())
+        {
+            return;
+        }
+        if (storage.header()->reference_count.release())
+        {
+            destroy_elements();
+            // The extracted temporary frees the storage.
+            (void)storage.extract_storage();
+        }
+        else
+        {
+            // The other arrays sharing the storage keep owning it.
+            (void)storage.extract_storage().leak_storage();
+        }
+    }
+
+    /// Gives this array its own copy of the storage, with space for `new_capacity` elements, if it's shared.
+    ///
+    /// Returns whether the storage was shared. Leaves the storage shared if copying an element throws.
+    /// Requires `new_capacity >= count()`.
+    auto unshare(const Int new_capacity) noexcept(nothrow_unshare) -> bool
+    {
+        if constexpr (std::copy_constructible<Element>)
+        {
+            if (storage.is_valid() && !storage.header()->reference_count.is_unique())
+            {
+                auto new_storage = copy_storage(new_capacity);
+                release_storage();
+                storage = std::move(new_storage);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Moves all elements into `destination`, leaving the current storage without live elements.
+    ///
+    /// Trivially relocatable elements are copied with a single memcpy, others are moved one by one, or copied if their
+    /// move constructor may throw. If constructing one throws, those already constructed in `destination` are destroyed
+    /// and the current storage keeps its elements. Requires `destination` to have space for at least `count()`
+    /// elements.
+    void relocate_elements_into(Storage& destination) noexcept(nothrow_relocation)
+    {
+        const Int element_count = count();
+        if constexpr (is_trivially_relocatable_v<Element>)
+        {
+            if (element_count != 0)
+            {
+                std::memcpy(static_cast<void*>(destination.element_address(0)), storage.element_address(0),
+                            sizeof(Element) * static_cast<size_t>(element_count));
+            }
+        }
+        else
+        {
+            ConstructedElements relocated{destination.element_address(0)};
+            for (; relocated.count < element_count; ++relocated.count)
+            {
+                std::construct_at(destination.element_address(relocated.count),
+                                  std::move_if_noexcept(*storage.element_address(relocated.count)));
+            }
+            relocated.first = nullptr;
+            std::destroy_n(storage.element_address(0), element_count);
+        }
+        if (element_count != 0)
+        {
+            storage.header()->count = 0;
+        }
+    }
+
+    /// Replaces the storage with an unshared one that has space for `new_capacity` elements, keeping the elements.
+    ///
+    /// Requires `new_capacity >= count()`.
+    void relocate_to(const Int new_capacity) noexcept(nothrow_unshare && nothrow_relocation)
+    {
+        if (unshare(new_capacity))
+        {
+            return;
+        }
+        if constexpr (is_trivially_relocatable_v<Element>)
+        {
+            if (storage.is_valid())
+            {
+                // The elements can be moved bytewise, so the allocator may extend or remap the block instead.
+                storage.reallocate(new_capacity);
+                storage.header()->capacity = new_capacity;
+                return;
+            }
+        }
+        auto new_storage = Storage::with_header(new_capacity, Header{count(), new_capacity});
+        relocate_elements_into(new_storage);
+        storage = std::move(new_storage);
+    }
+
+    /// Makes the storage valid and unshared with space for at least `minimum_capacity` elements, growing geometrically.
+    ///
+    /// Leaves an empty array with a storage of no elements, which the caller fills. Requires `minimum_capacity > 0`.
+    void prepare_to_grow(const Int minimum_capacity) noexcept(nothrow_unshare && nothrow_relocation)
     {
+        if (!storage.is_valid())
+        {
+            const Int new_capacity = std::max(minimum_capacity, minimum_grown_capacity);
+            storage = Storage::with_header(new_capacity, Header{0, new_capacity});
+        }
+        else if (minimum_capacity > capacity())
+        {
+            relocate_to(grown_capacity(minimum_capacity));
+        }
+        else
+        {
+            unshare(capacity());
+        }
+    }
+
+    /// Gives up the storage of `array` when destroyed, unless dismissed by clearing `array` first.
+    ///
+    /// Frees a storage allocated for an empty array when filling it throws, or adds no elements.
+    struct StorageRelease
+    {
+        Array* array;
+
+        ~StorageRelease()
+        {
+            if (array != nullptr)
+            {
+                array->release_storage();
+            }
+        }
+    };
+
+    /// The address of the first element for mutation by the members of this array, copying the elements first if the
+    /// storage is shared.
+    ///
+    /// Unlike the public accessors, it leaves the storage shareable, as no reference outlives the calling member.
+    /// Requires the array not to be empty.
+    [[nodiscard]] auto own_elements() noexcept(nothrow_unshare) -> Element*
+    {
+        unshare(capacity());
+        return storage.element_address(0);
+    }
+
+    /// The address of the first element for mutation by the caller, copying the elements first if the storage is
+    /// shared, and marking the storage unshareable.
+    ///
+    /// Requires the array not to be empty.
+    [[nodiscard]] auto leak_elements() noexcept(nothrow_unshare) -> Element*
+    {
+        Element* const first = own_elements();
+        storage.header()->unshareable = true;
+        return first;
+    }
+
+    /// Destroys all elements, keeping the storage.
+    ///
+    /// Requires the storage not to be shared.
+    void destroy_elements() noexcept
+    {
+        if (!storage.is_valid())
+        {
+            return;
+        }
+        for (Int i = 0; i < storage.header()->count; ++i)
+        {
+            std::destroy_at(storage.element_address(i));
+        }
+        storage.header()->count = 0;
     }
 
 public:
     /// Create an empty array with no heap allocation and zero capacity.
     [[nodiscard]] static auto create_empty() noexcept -> Array
     {
-        return Array{FlexibleArrayChecked<Header, Element>::create_empty()};
+        return Array{Storage::create_empty()};
     }
 
-    /// Creates an array with given capacity, heap-allocating storage unless capacity is zero.
+    /// Creates an empty array, with no heap allocation and zero capacity.
+    ///
+    /// As empty arrays hold no storage, `capacity` is not allocated up front; use `create_with_capacity` to pre-size
+    /// an array together with its first element.
     [[nodiscard]] static auto create_empty(const Int capacity) noexcept -> Array
     {
         precondition(capacity >= 0);
-        if (capacity == 0)
-        {
-            return Array::create_empty();
-        }
-        return Array{FlexibleArrayChecked<Header, Element>::with_header(capacity, Header{0, capacity})};
+        return Array::create_empty();
+    }
+
+    /// Creates an array of one element constructed from `arguments`, with space for `capacity` elements.
+    ///
+    /// The storage is allocated together with the first element, so that an array is pre-sized without ever holding a
+    /// storage of no elements. Requires `capacity >= 1`.
+    template <typename... Arguments>
+        requires std::constructible_from<Element, Arguments...>
+    [[nodiscard]] static auto create_with_capacity(const Int capacity, Arguments&&... arguments) -> Array
+    {
+        precondition(capacity >= 1, "An array with a first element needs a capacity of at least 1");
+        auto new_storage = Storage::with_header(capacity, Header{0, capacity});
+        std::construct_at(new_storage.element_address(0), std::forward<Arguments>(arguments)...);
+        new_storage.header()->count = 1;
+        return Array{std::move(new_storage)};
     }
 
     /// The number of initialized elements in the array.
@@ -63,5 +363,433 @@ public:
         return storage.is_valid() ? storage.capacity() : 0;
     }
 
-    
+    /// Whether the array has no elements, which is the case exactly when it holds no storage.
+    [[nodiscard]] constexpr auto empty() const noexcept -> bool { return !storage.is_valid(); }
+
+    /// The address of the storage, null exactly when the array is empty.
+    [[nodiscard]] auto storage_address() const noexcept -> const void* { return storage.storage_address(); }
+
+    /// Whether no other array shares the storage of this one, so that mutating it copies nothing.
+    [[nodiscard]] constexpr auto is_uniquely_referenced() const noexcept -> bool
+    {
+        return !storage.is_valid() || storage.header()->reference_count.is_unique();
+    }
+
+    /// Returns the `index`th element.
+    ///
+    /// Requires 0 <= `index` < `count()`.
+    [[nodiscard]] constexpr auto operator[](const Int index) const noexcept -> const Element&
+    {
+        precondition(index >= 0 && index < count(), "Index out of bounds");
+        return *storage.element_address(index);
+    }
+
+    /// Returns the `index`th element for mutation, copying the elements first if the storage is shared.
+    ///
+    /// Later copies of the array copy the elements rather than share them. Reading through `std::as_const` avoids both.
+    /// Requires 0 <= `index` < `count()`.
+    [[nodiscard]] auto operator[](const Int index) noexcept(nothrow_unshare) -> Element&
+    {
+        precondition(index >= 0 && index < count(), "Index out of bounds");
+        return leak_elements()[index];
+    }
+
+    /// The address of the first element, or null if the array is empty.
+    [[nodiscard]] auto begin() const noexcept -> const Element*
+    {
+        return storage.is_valid() ? storage.element_address(0) : nullptr;
+    }
+
+    /// The address past the last element, or null if the array is empty.
+    [[nodiscard]] auto end() const noexcept -> const Element* { return begin() + count(); }
+
+    /// The address of the first element for mutation, copying the elements first if the storage is shared.
+    ///
+    /// Null if the array is empty. Later copies of the array copy the elements rather than share them.
+    [[nodiscard]] auto begin() noexcept(nothrow_unshare) -> Element*
+    {
+        return storage.is_valid() ? leak_elements() : nullptr;
+    }
+
+    /// The address past the last element for mutation, copying the elements first if the storage is shared.
+    ///
+    /// Null if the array is empty.
+    [[nodiscard]] auto end() noexcept(nothrow_unshare) -> Element*
+    {
+        Element* const first = begin();
+        return first + count();
+    }
+
+    /// The address of the first element, or null if the array is empty.
+    [[nodiscard]] auto data() const noexcept -> const Element* { return begin(); }
+
+    /// The address of the first element for mutation, copying the elements first if the storage is shared.
+    ///
+    /// Null if the array is empty.
+    [[nodiscard]] auto data() noexcept(nothrow_unshare) -> Element* { return begin(); }
+
+    /// Views the elements as a span.
+    [[nodiscard]] operator std::span<const Element>() const noexcept // NOLINT(google-explicit-constructor)
+    {
+        return {begin(), static_cast<size_t>(count())};
+    }
+
+    /// Views the elements as a span for mutation, copying the elements first if the storage is shared.
+    [[nodiscard]] operator std::span<Element>() noexcept(nothrow_unshare) // NOLINT(google-explicit-constructor)
+    {
+        Element* const first = begin();
+        return {first, static_cast<size_t>(count())};
+    }
+
+    /// Ensures that the array has space for at least `minimum_capacity` elements without further allocation.
+    ///
+    /// Never shrinks the storage. Does nothing on an empty array, which holds no storage; use `create_with_capacity`
+    /// to pre-size an array together with its first element.
+    void reserve(const Int minimum_capacity) noexcept(nothrow_unshare && nothrow_relocation)
+    {
+        if (storage.is_valid() && minimum_capacity > capacity())
+        {
+            relocate_to(minimum_capacity);
+        }
+    }
+
+    /// Constructs a new element from `arguments` at the end of the array, returning a reference to it.
+    ///
+    /// Grows the storage geometrically when it is full, so that appending is amortized O(1).
+    template <typename... Arguments>
+        requires std::constructible_from<Element, Arguments...>
+    auto emplace_back(Arguments&&... arguments) -> Element&
+    {
+        if (!storage.is_valid())
+        {
+            // The first element allocates a fresh storage; there is nothing to copy or relocate. The storage counts the
+            // element only once it is constructed, and is freed without it if the construction throws.
+            auto new_storage = Storage::with_header(minimum_grown_capacity, Header{0, minimum_grown_capacity});
+            Element* place = std::construct_at(new_storage.element_address(0), std::forward<Arguments>(arguments)...);
+            new_storage.header()->count = 1;
+            storage = std::move(new_storage);
+            return *place;
+        }
+
+        const Int old_count = count();
+        const bool is_full = old_count == capacity();
+        const Int new_capacity = is_full ? grown_capacity(old_count + 1) : capacity();
+
+        // A shared storage outlives the copy, so `arguments` referring to its elements remain valid.
+        if (unshare(new_capacity) || !is_full)
+        {
+            Element* place =
+                std::construct_at(storage.element_address(old_count), std::forward<Arguments>(arguments)...);
+            storage.header()->count = old_count + 1;
+            return *place;
+        }
+
+        if constexpr (is_trivially_relocatable_v<Element>)
+        {
+            // `arguments` may refer to an element, so the new element is created before the storage moves.
+            Element element(std::forward<Arguments>(arguments)...);
+            relocate_to(new_capacity);
+            Element* place = std::construct_at(storage.element_address(old_count), std::move(element));
+            storage.header()->count = old_count + 1;
+            return *place;
+        }
+
+        // The new element is constructed before relocating the old ones, as `arguments` may refer to them.
+        auto new_storage = Storage::with_header(new_capacity, Header{0, new_capacity});
+        Element* place =
+            std::construct_at(new_storage.element_address(old_count), std::forward<Arguments>(arguments)...);
+        ConstructedElements new_element{place, 1};
+        relocate_elements_into(new_storage);
+        new_element.first = nullptr;
+        new_storage.header()->count = old_count + 1;
+        storage = std::move(new_storage);
+        return *place;
+    }
+
+    /// Appends a copy of `element` to the end of the array.
+    void append(const Element& element)
+        requires std::copy_constructible<Element>
+    {
+        emplace_back(element);
+    }
+
+    /// Appends `element` to the end of the array by moving it.
+    void append(Element&& element) { emplace_back(std::move(element)); }
+
+    /// Assigns `value` to every element, copying the elements first if the storage is shared.
+    ///
+    /// Trivially copyable elements are stored by the vectorized kernels of Bulk::fill.
+    void fill(const Element& value) noexcept(nothrow_unshare && std::is_nothrow_copy_assignable_v<Element>)
+        requires std::copyable<Element>
+    {
+        if (storage.is_valid())
+        {
+            Bulk::fill(std::span<Element>{own_elements(), static_cast<size_t>(count())}, value);
+        }
+    }
+
+    /// Replaces the elements with copies of the elements of `source`, which may be elements of this array.
+    ///
+    /// Reuses the storage when it is not shared and has space for `source`, copying trivially copyable elements with
+    /// a single memmove, which the C library already implements with the widest vectors of the running CPU. Otherwise
+    /// the copies go to a new storage of exactly the size of `source`. If a copy throws, the array keeps its elements.
+    void assign_from(const std::span<const Element> source) noexcept(std::is_nothrow_copy_constructible_v<Element>)
+        requires std::copy_constructible<Element>
+    {
+        const auto source_count = static_cast<Int>(source.size());
+        if (source_count == 0)
+        {
+            clear();
+            return;
+        }
+        if constexpr (std::is_trivially_copyable_v<Element>)
+        {
+            if (is_uniquely_referenced() && source_count <= capacity())
+            {
+                std::memmove(storage.element_address(0), source.data(), source.size_bytes());
+                storage.header()->count = source_count;
+                return;
+            }
+        }
+        auto new_storage = Storage::with_header(source_count, Header{0, source_count});
+        if constexpr (std::is_trivially_copyable_v<Element>)
+        {
+            std::memcpy(new_storage.element_address(0), source.data(), source.size_bytes());
+        }
+        else
+        {
+            ConstructedElements copies{new_storage.element_address(0)};
+            for (; copies.count < source_count; ++copies.count)
+            {
+                std::construct_at(new_storage.element_address(copies.count), source[static_cast<size_t>(copies.count)]);
+            }
+            copies.first = nullptr;
+        }
+        new_storage.header()->count = source_count;
+        // Releasing only now keeps `source` alive if it refers to the elements of this array.
+        release_storage();
+        storage = std::move(new_storage);
+    }
+
+    /// Appends up to `n` elements that `writer` writes directly into the storage, with no initialization beforehand.
+    ///
+    /// `writer` is called once with a span of `n` uninitialized elements after the last one, e.g. to `read()` into, and
+    /// returns the number of elements it wrote to the start of the span, or nothing if it wrote all of them. Only those
+    /// are appended. Returns the number of appended elements. Grows the storage like `append`, and copies the
+    /// elements first if the storage is shared. Requires `n >= 0`.
+    template <typename Writer>
+        requires std::is_trivially_copyable_v<Element> && std::invocable<Writer&, std::span<Element>>
+    auto append_uninitialized(const Int n, Writer&& writer) -> Int
+    {
+        precondition(n >= 0, "Cannot append a negative number of elements");
+        if (n == 0)
+        {
+            return 0;
+        }
+        const Int old_count = count();
+        const bool had_storage = storage.is_valid();
+        prepare_to_grow(old_count + n);
+        StorageRelease fresh_storage_release{had_storage ? nullptr : this};
+        const std::span<Element> destination{storage.element_address(old_count), static_cast<size_t>(n)};
+
+        Int written = n;
+        if constexpr (std::is_void_v<std::invoke_result_t<Writer&, std::span<Element>>>)
+        {
+            std::invoke(writer, destination);
+        }
+        else
+        {
+            written = static_cast<Int>(std::invoke(writer, destination));
+            precondition(written >= 0, "The writer reported a negative number of written elements");
+            precondition(written <= n, "The writer reported more elements than it was given");
+        }
+
+        if (written == 0)
+        {
+            // A storage allocated for this call is released, as an empty array holds no storage.
+            return 0;
+        }
+        fresh_storage_release.array = nullptr;
+        storage.header()->count = old_count + written;
+        return written;
+    }
+
+    /// Sets the number of elements to `new_count`, default-initializing the added ones.
+    ///
+    /// Trivially default constructible elements are left uninitialized, for the caller to overwrite without paying for
+    /// zeroing them first. Removed elements are destroyed. Copies the elements first if the storage is shared.
+    /// If default-initializing an element throws, the array keeps its elements. Requires `new_count >= 0`.
+    void resize_for_overwrite(const Int new_count) noexcept(
+        nothrow_unshare && nothrow_relocation && std::is_nothrow_default_constructible_v<Element>)
+        requires std::default_initializable<Element>
+    {
+        precondition(new_count >= 0, "Cannot resize to a negative number of elements");
+        const Int old_count = count();
+        if (new_count == 0)
+        {
+            clear();
+            return;
+        }
+        if (new_count <= old_count)
+        {
+            unshare(capacity());
+            std::destroy_n(storage.element_address(new_count), old_count - new_count);
+            storage.header()->count = new_count;
+            return;
+        }
+        const bool had_storage = storage.is_valid();
+        prepare_to_grow(new_count);
+        StorageRelease fresh_storage_release{had_storage ? nullptr : this};
+        // Default-initializing trivially default constructible elements compiles to nothing. A throwing one destroys
+        // those already initialized, and a storage allocated for this call is released.
+        std::uninitialized_default_construct_n(storage.element_address(old_count), new_count - old_count);
+        fresh_storage_release.array = nullptr;
+        storage.header()->count = new_count;
+    }
+
+    /// Destroys the last element.
+    ///
+    /// Requires the array not to be empty.
+    void pop_back() noexcept(nothrow_unshare)
+    {
+        precondition(!empty(), "Cannot remove an element from an empty array");
+        if (count() == 1)
+        {
+            clear();
+            return;
+        }
+        unshare(capacity());
+        std::destroy_at(storage.element_address(count() - 1));
+        --storage.header()->count;
+    }
+
+    /// Constructs a new element from `arguments` at `index`, moving the elements from there one place back.
+    ///
+    /// Trivially relocatable elements are moved with a single memmove. Grows the storage like `emplace_back`.
+    /// Returns a reference to the new element. Requires 0 <= `index` <= `count()`.
+    template <typename... Arguments>
+        requires std::constructible_from<Element, Arguments...>
+    auto emplace(const Int index, Arguments&&... arguments) -> Element&
+    {
+        const Int old_count = count();
+        precondition(index >= 0 && index <= old_count, "Index out of bounds");
+        if (index == old_count)
+        {
+            return emplace_back(std::forward<Arguments>(arguments)...);
+        }
+
+        // `arguments` may refer to an element, which moves below, so the new element is created first.
+        Element element(std::forward<Arguments>(arguments)...);
+        prepare_to_grow(old_count + 1);
+        Element* const place = storage.element_address(index);
+        const Int moved_count = old_count - index;
+        if constexpr (is_trivially_relocatable_v<Element>)
+        {
+            std::memmove(static_cast<void*>(place + 1), place, sizeof(Element) * static_cast<size_t>(moved_count));
+            std::construct_at(place, std::move(element));
+        }
+        else
+        {
+            std::construct_at(place + moved_count, std::move(place[moved_count - 1]));
+            std::move_backward(place, place + moved_count - 1, place + moved_count);
+            *place = std::move(element);
+        }
+        storage.header()->count = old_count + 1;
+        return *place;
+    }
+
+    /// Inserts a copy of `element` at `index`.
+    ///
+    /// Requires 0 <= `index` <= `count()`.
+    void insert(const Int index, const Element& element)
+        requires std::copy_constructible<Element>
+    {
+        emplace(index, element);
+    }
+
+    /// Inserts `element` at `index` by moving it.
+    ///
+    /// Requires 0 <= `index` <= `count()`.
+    void insert(const Int index, Element&& element) { emplace(index, std::move(element)); }
+
+    /// Removes the `index`th element, moving the elements after it one place forward.
+    ///
+    /// Trivially relocatable elements are moved with a single memmove. Requires 0 <= `index` < `count()`.
+    void erase(const Int index)
+        noexcept(nothrow_unshare && (is_trivially_relocatable_v<Element> || std::is_nothrow_move_assignable_v<Element>))
+    {
+        precondition(index >= 0 && index < count(), "Index out of bounds");
+        if (count() == 1)
+        {
+            clear();
+            return;
+        }
+        unshare(capacity());
+        const Int last = count() - 1;
+        if constexpr (is_trivially_relocatable_v<Element>)
+        {
+            Element* const place = storage.element_address(index);
+            std::destroy_at(place);
+            std::memmove(static_cast<void*>(place), place + 1, sizeof(Element) * static_cast<size_t>(last - index));
+        }
+        else
+        {
+            for (Int i = index; i < last; ++i)
+            {
+                *storage.element_address(i) = std::move(*storage.element_address(i + 1));
+            }
+            std::destroy_at(storage.element_address(last));
+        }
+        storage.header()->count = last;
+    }
+
+    /// Removes all elements and gives up the storage.
+    void clear() noexcept { release_storage(); }
+
+    /// Copy constructor, sharing the storage of `other` in O(1).
+    ///
+    /// Copies the elements instead if a mutable reference into `other` was handed out.
+    Array(const Array& other) noexcept(std::is_nothrow_copy_constructible_v<Element>)
+        requires std::copy_constructible<Element>
+        : storage(other.storage_for_copy())
+    {
+    }
+
+    /// Copy assignment operator, sharing the storage of `other` in O(1) like the copy constructor.
+    Array& operator=(const Array& other) noexcept(std::is_nothrow_copy_constructible_v<Element>)
+        requires std::copy_constructible<Element>
+    {
+        if (this != &other)
+        {
+            *this = Array{other};
+        }
+        return *this;
+    }
+
+    /// Move constructor, leaving `other` empty.
+    Array(Array&& other) noexcept = default;
+
+    /// Move assignment operator, giving up the storage held before the assignment.
+    Array& operator=(Array&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release_storage();
+            storage = std::move(other.storage);
+        }
+        return *this;
+    }
+
+    /// Gives up the storage, destroying the elements if no other array shares them.
+    ~Array() { release_storage(); }
+};
+
+static_assert(sizeof(Array<Int>) == sizeof(void*));
+
+/// An array is relocated by copying its storage pointer.
+template <typename Element, StorageAllocator Allocator, ReferenceCounter Counter>
+struct is_trivially_relocatable<Array<Element, Allocator, Counter>> : std::true_type
+{
 };
+
+#endif // CPP_MVS_ARRAY_HPP
@@ -0,0 +1,626 @@
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <print>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "array.hpp"
+#include "bulk_algorithms.hpp"
+#include "flexible_array_checked.hpp"
+#include "flexible_array_unchecked.hpp"
+#include "library.h"
+#include "perf_counters.hpp"
+#include "small_array.hpp"
+
+// Element types mirroring the ones exercised by the unit tests.
+struct SmallElement
+{
+    char c;
+};
+
+struct alignas(64) OverAlignedElement
+{
+    char data[64];
+};
+
+/// Reads the first byte of `element`, so that accessing an element cannot be optimized away.
+template <typename Element>
+[[nodiscard]] auto first_byte(const Element& element) noexcept -> Int
+{
+    return *reinterpret_cast<const unsigned char*>(&element);
+}
+
+/// The header of the flexible arrays under measurement, which only knows the capacity.
+struct CapacityHeader
+{
+    Int capacity;
+
+    [[nodiscard]] explicit CapacityHeader(const Int capacity) noexcept : capacity(capacity) {}
+
+    [[nodiscard]] Int trailing_element_count() const { return capacity; }
+};
+
+// Adapters giving every container the same interface:
+// - `filled(n)` creates a container holding `n` value-initialized elements, allocating once.
+// - `appended(n)` creates a container by adding `n` elements one by one, growing as the container does.
+// - `at(container, i)` reads the `i`th element.
+
+template <typename Element>
+struct VectorAdapter
+{
+    using Container = std::vector<Element>;
+    static constexpr auto name = "std::vector";
+
+    [[nodiscard]] static auto filled(const Int n) -> Container { return Container(static_cast<size_t>(n)); }
+
+    [[nodiscard]] static auto appended(const Int n) -> Container
+    {
+        Container container;
+        for (Int i = 0; i < n; ++i)
+        {
+            container.emplace_back();
+        }
+        return container;
+    }
+
+    [[nodiscard]] static auto at(const Container& container, const Int i) -> const Element&
+    {
+        return container[static_cast<size_t>(i)];
+    }
+};
+
+/// Flexible arrays have a fixed capacity and don't track their count, so appending constructs into a storage
+/// allocated up front.
+template <typename FlexibleArray, typename Element>
+    requires std::is_trivially_destructible_v<Element>
+struct FlexibleArrayAdapter
+{
+    using Container = FlexibleArray;
+
+    [[nodiscard]] static auto filled(const Int n) -> Container
+    {
+        auto container = Container::with_header(n, CapacityHeader{n});
+        for (Int i = 0; i < n; ++i)
+        {
+            std::construct_at(container.element_address(i));
+        }
+        return container;
+    }
+
+    [[nodiscard]] static auto appended(const Int n) -> Container { return filled(n); }
+
+    [[nodiscard]] static auto at(const Container& container, const Int i) -> const Element&
+    {
+        return *container.element_address(i);
+    }
+};
+
+template <typename Element>
+struct FlexibleArrayCheckedAdapter : FlexibleArrayAdapter<FlexibleArrayChecked<CapacityHeader, Element>, Element>
+{
+    static constexpr auto name = "FlexibleArrayChecked";
+};
+
+template <typename Element>
+struct FlexibleArrayUncheckedAdapter : FlexibleArrayAdapter<FlexibleArrayUnchecked<CapacityHeader, Element>, Element>
+{
+    static constexpr auto name = "FlexibleArrayUnchecked";
+};
+
+template <typename Element>
+struct ArrayAdapter
+{
+    using Container = Array<Element>;
+    static constexpr auto name = "Array";
+
+    [[nodiscard]] static auto filled(const Int n) -> Container
+    {
+        if (n == 0)
+        {
+            return Container::create_empty();
+        }
+        // The storage is allocated with the first element, as empty arrays hold none.
+        auto container = Container::create_with_capacity(n);
+        for (Int i = 1; i < n; ++i)
+        {
+            container.emplace_back();
+        }
+        return container;
+    }
+
+    [[nodiscard]] static auto appended(const Int n) -> Container
+    {
+        auto container = Container::create_empty();
+        for (Int i = 0; i < n; ++i)
+        {
+            container.emplace_back();
+        }
+        return container;
+    }
+
+    [[nodiscard]] static auto at(const Container& container, const Int i) -> const Element& { return container[i]; }
+};
+
+/// A small-buffer-optimized container, in the style of `boost::container::small_vector`.
+template <typename Element>
+struct SmallArrayAdapter
+{
+    using Container = SmallArray<Element, 8>;
+    static constexpr auto name = "SmallArray<8>";
+
+    [[nodiscard]] static auto filled(const Int n) -> Container
+    {
+        auto container = Container::create_empty();
+        container.reserve(n);
+        for (Int i = 0; i < n; ++i)
+        {
+            container.emplace_back();
+        }
+        return container;
+    }
+
+    [[nodiscard]] static auto appended(const Int n) -> Container
+    {
+        auto container = Container::create_empty();
+        for (Int i = 0; i < n; ++i)
+        {
+            container.emplace_back();
+        }
+        return container;
+    }
+
+    [[nodiscard]] static auto at(const Container& container, const Int i) -> const Element& { return container[i]; }
+};
+
+/// Counts hardware events over the timed part of a benchmark, reporting them per processed item.
+///
+/// Created right before the benchmark loop and finished right after it. Benchmarks run without counts where
+/// `perf_event_open` is unavailable, e.g. in containers, and are labelled accordingly.
+class MeasuredRegion
+{
+    benchmark::State& state;
+    PerfCounters counters;
+
+public:
+    [[nodiscard]] explicit MeasuredRegion(benchmark::State& state) noexcept : state(state) { counters.start(); }
+
+    /// Pauses both the timer and the counters.
+    void pause()
+    {
+        counters.stop();
+        state.PauseTiming();
+    }
+
+    /// Resumes both the timer and the counters.
+    void resume()
+    {
+        state.ResumeTiming();
+        counters.start();
+    }
+
+    /// Stops counting, reporting the number of processed `items` and the counts per item.
+    void finish(const Int items)
+    {
+        counters.stop();
+        state.SetItemsProcessed(items);
+        if (!counters.is_any_available())
+        {
+            state.SetLabel("perf counters unavailable");
+            return;
+        }
+        for (Int i = 0; i < perf_event_count; ++i)
+        {
+            const auto event = static_cast<PerfEvent>(i);
+            if (const auto total = counters.total(event))
+            {
+                state.counters[perf_event_name(event)] = *total / static_cast<double>(std::max(items, Int{1}));
+            }
+        }
+    }
+};
+
+/// The number of containers created or destroyed per timed batch, amortizing the cost of pausing the timer.
+constexpr Int batch_size = 64;
+
+template <typename Adapter>
+void benchmark_create(benchmark::State& state)
+{
+    const Int n = state.range(0);
+    std::vector<typename Adapter::Container> batch;
+    batch.reserve(batch_size);
+    MeasuredRegion region{state};
+    for (auto _ : state)
+    {
+        for (Int i = 0; i < batch_size; ++i)
+        {
+            batch.push_back(Adapter::filled(n));
+        }
+        benchmark::ClobberMemory();
+
+        region.pause();
+        batch.clear();
+        region.resume();
+    }
+    region.finish(state.iterations() * batch_size);
+}
+
+template <typename Adapter>
+void benchmark_destroy(benchmark::State& state)
+{
+    const Int n = state.range(0);
+    std::vector<typename Adapter::Container> batch;
+    batch.reserve(batch_size);
+    MeasuredRegion region{state};
+    for (auto _ : state)
+    {
+        region.pause();
+        for (Int i = 0; i < batch_size; ++i)
+        {
+            batch.push_back(Adapter::filled(n));
+        }
+        region.resume();
+
+        batch.clear();
+        benchmark::ClobberMemory();
+    }
+    region.finish(state.iterations() * batch_size);
+}
+
+template <typename Adapter>
+void benchmark_append(benchmark::State& state)
+{
+    const Int n = state.range(0);
+    MeasuredRegion region{state};
+    for (auto _ : state)
+    {
+        auto container = Adapter::appended(n);
+        benchmark::DoNotOptimize(container);
+    }
+    region.finish(state.iterations() * n);
+}
+
+template <typename Adapter>
+void benchmark_random_access(benchmark::State& state)
+{
+    const Int n = state.range(0);
+    const auto container = Adapter::filled(n);
+
+    std::mt19937_64 generator{42};
+    std::uniform_int_distribution<Int> distribution{0, n - 1};
+    std::vector<Int> indices(1024);
+    for (Int& index : indices)
+    {
+        index = distribution(generator);
+    }
+
+    MeasuredRegion region{state};
+    for (auto _ : state)
+    {
+        Int sum = 0;
+        for (const Int index : indices)
+        {
+            sum += first_byte(Adapter::at(container, index));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    region.finish(state.iterations() * static_cast<Int>(indices.size()));
+}
+
+template <typename Adapter>
+void benchmark_iterate(benchmark::State& state)
+{
+    const Int n = state.range(0);
+    const auto container = Adapter::filled(n);
+    MeasuredRegion region{state};
+    for (auto _ : state)
+    {
+        Int sum = 0;
+        for (Int i = 0; i < n; ++i)
+        {
+            sum += first_byte(Adapter::at(container, i));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    region.finish(state.iterations() * n);
+}
+
+template <typename Adapter>
+void benchmark_move(benchmark::State& state)
+{
+    auto container = Adapter::filled(state.range(0));
+    MeasuredRegion region{state};
+    for (auto _ : state)
+    {
+        auto moved = std::move(container);
+        benchmark::DoNotOptimize(moved);
+        container = std::move(moved);
+        benchmark::DoNotOptimize(container);
+    }
+    region.finish(state.iterations() * 2);
+}
+
+// Bounds-checked scans: the same summing loop over a raw pointer, over UnsafeBufferPointer with the cold out-of-line
+// precondition failure, and over a buffer inlining the failure reporting into every access. Each kernel is kept out
+// of line in its own ELF section, so that its code size can be read from the section bounds the linker defines.
+
+/// A bounds-checked buffer reporting failures inline, like `precondition` did before it got a cold failure path.
+struct InlineFailureBuffer
+{
+    const int* start;
+    Int count;
+
+    [[nodiscard]] auto operator[](const Int index) const noexcept -> const int&
+    {
+        if (!(index >= 0 && index < count))
+        {
+            std::println("Assertion failure: {}\n", "Index out of bounds");
+            std::quick_exit(EXIT_FAILURE);
+        }
+        return start[index];
+    }
+};
+
+#if defined(__ELF__)
+#define BOUNDS_CHECK_KERNEL(section_name) [[gnu::noinline, gnu::section(#section_name)]]
+extern "C" const char __start_bounds_check_raw[], __stop_bounds_check_raw[];
+extern "C" const char __start_bounds_check_cold[], __stop_bounds_check_cold[];
+extern "C" const char __start_bounds_check_inline[], __stop_bounds_check_inline[];
+#else
+#define BOUNDS_CHECK_KERNEL(section_name) [[gnu::noinline]]
+#endif
+
+BOUNDS_CHECK_KERNEL(bounds_check_raw) auto sum_raw(const int* values, const Int n) noexcept -> Int
+{
+    Int sum = 0;
+    for (Int i = 0; i < n; ++i)
+    {
+        sum += values[i];
+    }
+    return sum;
+}
+
+BOUNDS_CHECK_KERNEL(bounds_check_cold) auto sum_cold_checked(const UnsafeBufferPointer<const int> values,
+                                                             const Int n) noexcept -> Int
+{
+    Int sum = 0;
+    for (Int i = 0; i < n; ++i)
+    {
+        sum += values[i];
+    }
+    return sum;
+}
+
+BOUNDS_CHECK_KERNEL(bounds_check_inline) auto sum_inline_checked(const InlineFailureBuffer values,
+                                                                 const Int n) noexcept -> Int
+{
+    Int sum = 0;
+    for (Int i = 0; i < n; ++i)
+    {
+        sum += values[i];
+    }
+    return sum;
+}
+
+/// The kinds of summing loops compared by `benchmark_bounds_checks`.
+enum class BoundsCheckKernel
+{
+    raw,
+    cold,
+    inline_failure,
+};
+
+template <BoundsCheckKernel kernel>
+void benchmark_bounds_checks(benchmark::State& state)
+{
+    const Int n = state.range(0);
+    std::vector<int> values(static_cast<size_t>(n), 1);
+    // Passed separately from the buffers, so that the compiler cannot prove the checks redundant.
+    Int count = n;
+    benchmark::DoNotOptimize(count);
+
+    MeasuredRegion region{state};
+    for (auto _ : state)
+    {
+        Int sum = 0;
+        if constexpr (kernel == BoundsCheckKernel::raw)
+        {
+            sum = sum_raw(values.data(), count);
+        }
+        else if constexpr (kernel == BoundsCheckKernel::cold)
+        {
+            sum = sum_cold_checked(UnsafeBufferPointer<const int>{values.data(), n}, count);
+        }
+        else
+        {
+            sum = sum_inline_checked(InlineFailureBuffer{values.data(), n}, count);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    region.finish(state.iterations() * n);
+
+#if defined(__ELF__)
+    const auto code_bytes = [](const char* start, const char* stop) { return static_cast<double>(stop - start); };
+    if constexpr (kernel == BoundsCheckKernel::raw)
+    {
+        state.counters["code_bytes"] = code_bytes(__start_bounds_check_raw, __stop_bounds_check_raw);
+    }
+    else if constexpr (kernel == BoundsCheckKernel::cold)
+    {
+        state.counters["code_bytes"] = code_bytes(__start_bounds_check_cold, __stop_bounds_check_cold);
+    }
+    else
+    {
+        state.counters["code_bytes"] = code_bytes(__start_bounds_check_inline, __stop_bounds_check_inline);
+    }
+#endif
+}
+
+/// Registers the bounds check comparison, named like `bounds_checks/cold/512`.
+void register_bounds_check_benchmarks()
+{
+    const std::pair<const char*, void (*)(benchmark::State&)> kernels[] = {
+        {"bounds_checks/raw", benchmark_bounds_checks<BoundsCheckKernel::raw>},
+        {"bounds_checks/cold", benchmark_bounds_checks<BoundsCheckKernel::cold>},
+        {"bounds_checks/inline_failure", benchmark_bounds_checks<BoundsCheckKernel::inline_failure>},
+    };
+    for (const auto& [name, function] : kernels)
+    {
+        benchmark::RegisterBenchmark(name, function)->RangeMultiplier(8)->Range(64, 32768);
+    }
+}
+
+/// The searches compared by `benchmark_find`.
+enum class FindImplementation
+{
+    standard,
+    bulk,
+};
+
+template <FindImplementation implementation>
+void benchmark_find(benchmark::State& state)
+{
+    const Int n = state.range(0);
+    // Only the last element matches, so that every element is compared.
+    std::vector<Int> values(static_cast<size_t>(n), 0);
+    values.back() = 1;
+
+    MeasuredRegion region{state};
+    for (auto _ : state)
+    {
+        Int index = 0;
+        if constexpr (implementation == FindImplementation::standard)
+        {
+            index = std::ranges::find(values, Int{1}) - values.begin();
+        }
+        else
+        {
+            index = Bulk::find(values, Int{1});
+        }
+        benchmark::DoNotOptimize(index);
+        benchmark::ClobberMemory();
+    }
+    region.finish(state.iterations() * n);
+    if constexpr (implementation == FindImplementation::bulk)
+    {
+        state.SetLabel(SimdKernels::active().name);
+    }
+}
+
+/// Registers the comparison of `std::ranges::find` with `Bulk::find` over `Int`, named like `find/bulk/512`.
+void register_find_benchmarks()
+{
+    const std::pair<const char*, void (*)(benchmark::State&)> implementations[] = {
+        {"find/std", benchmark_find<FindImplementation::standard>},
+        {"find/bulk", benchmark_find<FindImplementation::bulk>},
+    };
+    for (const auto& [name, function] : implementations)
+    {
+        benchmark::RegisterBenchmark(name, function)->RangeMultiplier(8)->Range(64, 32768);
+    }
+}
+
+/// Inserts a handle into the middle of `Container` of `n` handles and erases it again.
+template <typename Container>
+void benchmark_insert_middle(benchmark::State& state)
+{
+    constexpr bool is_vector = std::is_same_v<Container, std::vector<std::unique_ptr<int>>>;
+    const Int n = state.range(0);
+    auto container = [] {
+        if constexpr (is_vector)
+        {
+            return Container{};
+        }
+        else
+        {
+            return Container::create_empty();
+        }
+    }();
+    for (Int i = 0; i < n; ++i)
+    {
+        container.emplace_back(std::make_unique<int>(static_cast<int>(i)));
+    }
+
+    MeasuredRegion region{state};
+    for (auto _ : state)
+    {
+        if constexpr (is_vector)
+        {
+            container.insert(container.begin() + (n / 2), std::make_unique<int>(-1));
+            container.erase(container.begin() + (n / 2));
+        }
+        else
+        {
+            container.insert(n / 2, std::make_unique<int>(-1));
+            container.erase(n / 2);
+        }
+        benchmark::DoNotOptimize(container.data());
+    }
+    region.finish(state.iterations());
+}
+
+/// Registers the middle insertion of move-only handles, which Array moves with memmove, named like
+/// `insert_middle/Array/4096`.
+void register_insert_benchmarks()
+{
+    const std::pair<const char*, void (*)(benchmark::State&)> containers[] = {
+        {"insert_middle/std::vector", benchmark_insert_middle<std::vector<std::unique_ptr<int>>>},
+        {"insert_middle/Array", benchmark_insert_middle<Array<std::unique_ptr<int>>>},
+    };
+    for (const auto& [name, function] : containers)
+    {
+        benchmark::RegisterBenchmark(name, function)->RangeMultiplier(8)->Range(64, 32768);
+    }
+}
+
+/// Registers every operation for the container of `Adapter` holding `Element`s, named like
+/// `std::vector<double>/append/512`.
+template <template <typename> typename Adapter, typename Element>
+void register_container_benchmarks(const std::string& element_name)
+{
+    using ElementAdapter = Adapter<Element>;
+    const std::string prefix = std::string(ElementAdapter::name) + "<" + element_name + ">/";
+
+    const std::pair<const char*, void (*)(benchmark::State&)> operations[] = {
+        {"create", benchmark_create<ElementAdapter>},
+        {"destroy", benchmark_destroy<ElementAdapter>},
+        {"append", benchmark_append<ElementAdapter>},
+        {"random_access", benchmark_random_access<ElementAdapter>},
+        {"iterate", benchmark_iterate<ElementAdapter>},
+        {"move", benchmark_move<ElementAdapter>},
+    };
+    for (const auto& [operation, function] : operations)
+    {
+        benchmark::RegisterBenchmark((prefix + operation).c_str(), function)->RangeMultiplier(8)->Range(8, 4096);
+    }
+}
+
+template <template <typename> typename Adapter>
+void register_container_benchmarks()
+{
+    register_container_benchmarks<Adapter, SmallElement>("SmallElement");
+    register_container_benchmarks<Adapter, double>("double");
+    register_container_benchmarks<Adapter, OverAlignedElement>("OverAlignedElement");
+}
+
+int main(int argc, char** argv)
+{
+    register_container_benchmarks<VectorAdapter>();
+    register_container_benchmarks<FlexibleArrayCheckedAdapter>();
+    register_container_benchmarks<FlexibleArrayUncheckedAdapter>();
+    register_container_benchmarks<ArrayAdapter>();
+    register_container_benchmarks<SmallArrayAdapter>();
+    register_bounds_check_benchmarks();
+    register_find_benchmarks();
+    register_insert_benchmarks();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
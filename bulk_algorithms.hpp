@@ -0,0 +1,219 @@
+#ifndef CPP_MVS_BULK_ALGORITHMS_HPP
+#define CPP_MVS_BULK_ALGORITHMS_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "library.h"
+#include "simd_kernels.hpp"
+
+namespace Detail
+{
+    /// Whether equality of `Element` is equality of its bytes, and there are kernels for its size.
+    ///
+    /// Limited to integers, enumerations and pointers. Classes may define an `operator==` that compares something else
+    /// than their bytes, and equal floating-point values may differ in their bytes.
+    template <typename Element>
+    concept BytewiseComparable = (std::is_integral_v<Element> || std::is_enum_v<Element> ||
+                                  std::is_pointer_v<Element>) &&
+                                 std::has_unique_object_representations_v<Element> &&
+                                 SimdKernels::has_kernels_for_size(sizeof(Element));
+
+    /// Whether comparing `Element`s for equality cannot throw.
+    template <typename Element>
+    inline constexpr bool is_nothrow_equality_comparable =
+        noexcept(std::declval<const Element&>() == std::declval<const Element&>());
+
+    /// Whether ordering `Element`s cannot throw.
+    template <typename Element>
+    inline constexpr bool is_nothrow_ordered = noexcept(std::declval<const Element&>() < std::declval<const Element&>());
+
+    /// Whether the smallest and largest `Element` can be found by the kernels of signed integers.
+    template <typename Element>
+    concept KernelMinMaxComparable = std::signed_integral<Element> && (sizeof(Element) == 4 || sizeof(Element) == 8);
+
+    /// The bytes of the elements of `range`.
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]] auto bytes_of(const Range& range) noexcept -> const std::byte*
+    {
+        return reinterpret_cast<const std::byte*>(std::ranges::data(range));
+    }
+
+    /// The smallest and the largest element of the non-empty `range`, found by the kernels.
+    template <std::ranges::contiguous_range Range>
+        requires std::ranges::sized_range<Range> && KernelMinMaxComparable<std::ranges::range_value_t<Range>>
+    [[nodiscard]] auto kernel_min_max(const Range& range) noexcept
+        -> std::pair<std::ranges::range_value_t<Range>, std::ranges::range_value_t<Range>>
+    {
+        using Element = std::ranges::range_value_t<Range>;
+        const auto& kernels = SimdKernels::active();
+        const auto kernel = sizeof(Element) == 4 ? kernels.min_max_i32 : kernels.min_max_i64;
+        std::pair<Element, Element> result;
+        kernel(bytes_of(range), static_cast<Int>(std::ranges::size(range)), reinterpret_cast<std::byte*>(&result.first),
+               reinterpret_cast<std::byte*>(&result.second));
+        return result;
+    }
+} // namespace Detail
+
+/// Algorithms over contiguous ranges, such as Array, std::span and std::vector, that use the vectorized kernels of
+/// SimdKernels for elements that are compared or copied as bytes, and fall back to the standard algorithms otherwise.
+///
+/// Queries take the range as const, so that they never copy the elements of a shared Array. They only throw what the
+/// element comparisons, assignments or predicates they call throw.
+namespace Bulk
+{
+    /// Assigns `value` to every element of `range`.
+    template <std::ranges::contiguous_range Range>
+        requires std::ranges::sized_range<Range> && std::ranges::output_range<Range, std::ranges::range_value_t<Range>>
+    void fill(Range&& range, const std::ranges::range_value_t<Range>& value) noexcept(
+        std::is_nothrow_copy_assignable_v<std::ranges::range_value_t<Range>>)
+    {
+        using Element = std::ranges::range_value_t<Range>;
+        if constexpr (std::is_trivially_copyable_v<Element> && SimdKernels::has_kernels_for_size(sizeof(Element)))
+        {
+            const auto count = static_cast<Int>(std::ranges::size(range));
+            if (count != 0)
+            {
+                const auto kernel = SimdKernels::active().fill[SimdKernels::size_index(sizeof(Element))];
+                kernel(reinterpret_cast<std::byte*>(std::ranges::data(range)), count, SimdKernels::bit_pattern(value));
+            }
+        }
+        else
+        {
+            std::ranges::fill(range, value);
+        }
+    }
+
+    /// Whether `a` and `b` have the same number of elements, and equal elements at each index.
+    template <std::ranges::contiguous_range A, std::ranges::contiguous_range B>
+        requires std::ranges::sized_range<A> && std::ranges::sized_range<B> &&
+                 std::same_as<std::ranges::range_value_t<A>, std::ranges::range_value_t<B>> &&
+                 std::equality_comparable<std::ranges::range_value_t<A>>
+    [[nodiscard]] auto equal(const A& a, const B& b) noexcept(
+        Detail::is_nothrow_equality_comparable<std::ranges::range_value_t<A>>) -> bool
+    {
+        using Element = std::ranges::range_value_t<A>;
+        const size_t count = std::ranges::size(a);
+        if (count != std::ranges::size(b))
+        {
+            return false;
+        }
+        if constexpr (Detail::BytewiseComparable<Element>)
+        {
+            return count == 0 || SimdKernels::active().equal(Detail::bytes_of(a), Detail::bytes_of(b),
+                                                             count * sizeof(Element));
+        }
+        else
+        {
+            return std::ranges::equal(a, b);
+        }
+    }
+
+    /// The index of the first element of `range` equal to `value`, or the number of elements if there is none.
+    template <std::ranges::contiguous_range Range>
+        requires std::ranges::sized_range<Range> && std::equality_comparable<std::ranges::range_value_t<Range>>
+    [[nodiscard]] auto find(const Range& range, const std::ranges::range_value_t<Range>& value) noexcept(
+        Detail::is_nothrow_equality_comparable<std::ranges::range_value_t<Range>>) -> Int
+    {
+        using Element = std::ranges::range_value_t<Range>;
+        const auto count = static_cast<Int>(std::ranges::size(range));
+        if constexpr (Detail::BytewiseComparable<Element>)
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+            const auto kernel = SimdKernels::active().find[SimdKernels::size_index(sizeof(Element))];
+            return kernel(Detail::bytes_of(range), count, SimdKernels::bit_pattern(value));
+        }
+        else
+        {
+            return std::ranges::find(range, value) - std::ranges::begin(range);
+        }
+    }
+
+    /// The number of elements of `range` equal to `value`.
+    template <std::ranges::contiguous_range Range>
+        requires std::ranges::sized_range<Range> && std::equality_comparable<std::ranges::range_value_t<Range>>
+    [[nodiscard]] auto count(const Range& range, const std::ranges::range_value_t<Range>& value) noexcept(
+        Detail::is_nothrow_equality_comparable<std::ranges::range_value_t<Range>>) -> Int
+    {
+        using Element = std::ranges::range_value_t<Range>;
+        const auto count = static_cast<Int>(std::ranges::size(range));
+        if constexpr (Detail::BytewiseComparable<Element>)
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+            const auto kernel = SimdKernels::active().count[SimdKernels::size_index(sizeof(Element))];
+            return kernel(Detail::bytes_of(range), count, SimdKernels::bit_pattern(value));
+        }
+        else
+        {
+            return std::ranges::count(range, value);
+        }
+    }
+
+    /// The number of elements of `range` satisfying `predicate`.
+    ///
+    /// Adds up the results without branching on them, so that the compiler can vectorize the loop when `predicate` is
+    /// simple, such as a comparison with a constant.
+    template <std::ranges::contiguous_range Range, std::predicate<const std::ranges::range_value_t<Range>&> Predicate>
+        requires std::ranges::sized_range<Range>
+    [[nodiscard]] auto count_if(const Range& range, Predicate predicate) noexcept(
+        std::is_nothrow_invocable_v<Predicate&, const std::ranges::range_value_t<Range>&>) -> Int
+    {
+        const auto* const elements = std::ranges::data(range);
+        const auto count = static_cast<Int>(std::ranges::size(range));
+        Int matches = 0;
+        for (Int i = 0; i < count; ++i)
+        {
+            matches += static_cast<Int>(static_cast<bool>(predicate(elements[i])));
+        }
+        return matches;
+    }
+
+    /// The smallest element of `range`.
+    ///
+    /// Requires `range` not to be empty.
+    template <std::ranges::contiguous_range Range>
+        requires std::ranges::sized_range<Range> && std::totally_ordered<std::ranges::range_value_t<Range>>
+    [[nodiscard]] auto min(const Range& range) noexcept(Detail::is_nothrow_ordered<std::ranges::range_value_t<Range>>)
+        -> std::ranges::range_value_t<Range>
+    {
+        precondition(!std::ranges::empty(range), "Cannot find the smallest element of an empty range");
+        if constexpr (Detail::KernelMinMaxComparable<std::ranges::range_value_t<Range>>)
+        {
+            return Detail::kernel_min_max(range).first;
+        }
+        else
+        {
+            return std::ranges::min(range);
+        }
+    }
+
+    /// The largest element of `range`.
+    ///
+    /// Requires `range` not to be empty.
+    template <std::ranges::contiguous_range Range>
+        requires std::ranges::sized_range<Range> && std::totally_ordered<std::ranges::range_value_t<Range>>
+    [[nodiscard]] auto max(const Range& range) noexcept(Detail::is_nothrow_ordered<std::ranges::range_value_t<Range>>)
+        -> std::ranges::range_value_t<Range>
+    {
+        precondition(!std::ranges::empty(range), "Cannot find the largest element of an empty range");
+        if constexpr (Detail::KernelMinMaxComparable<std::ranges::range_value_t<Range>>)
+        {
+            return Detail::kernel_min_max(range).second;
+        }
+        else
+        {
+            return std::ranges::max(range);
+        }
+    }
+} // namespace Bulk
+
+#endif // CPP_MVS_BULK_ALGORITHMS_HPP
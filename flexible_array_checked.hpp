@@ -1,28 +1,47 @@
 #ifndef CPP_MVS_FLEXIBLE_ARRAY_CHECKED_HPP
 #define CPP_MVS_FLEXIBLE_ARRAY_CHECKED_HPP
 
+#include <span>
 #include "flexible_array_unchecked.hpp"
 
 /// A wrapper around FlexibleArrayUnchecked that provides bounds-checked access to elements.
 ///
-/// This class retrieves the capacity from the header and performs precondition checks to ensure safe access.
-template <TrailingElementCountProvider Header, typename Element>
+/// This class retrieves the capacity from the header and performs precondition checks to ensure safe access. Whether
+/// the checks are compiled in is decided by `bounds_checking` of the build.
+template <TrailingElementCountProvider Header, typename Element, StorageAllocator Allocator = DefaultAllocator,
+          StorageLayoutPolicy Layout = HeaderFirstLayout>
 class FlexibleArrayChecked {
+public:
+    /// The layout of the storage.
+    static constexpr StorageLayoutDescriptor layout = FlexibleArrayUnchecked<Header, Element, Allocator, Layout>::layout;
+
 private:
-    FlexibleArrayUnchecked<Header, Element> unchecked_storage;
+    FlexibleArrayUnchecked<Header, Element, Allocator, Layout> unchecked_storage;
 
     /// Constructs the FlexibleArrayChecked by taking ownership of an existing unchecked instance
-    constexpr FlexibleArrayChecked(FlexibleArrayUnchecked<Header, Element>&& unchecked) noexcept
+    constexpr FlexibleArrayChecked(FlexibleArrayUnchecked<Header, Element, Allocator, Layout>&& unchecked) noexcept
         : unchecked_storage(std::move(unchecked)) {}
+
+    /// Moves the storage of a projected temporary back to the unchecked projection when the consumer returns or throws,
+    /// so that the checked wrapper never releases storage it does not own.
+    struct ProjectionRestorer
+    {
+        FlexibleArrayChecked& checked;
+        FlexibleArrayUnchecked<Header, Element, Allocator, Layout>& unchecked;
+
+        ~ProjectionRestorer() { unchecked = checked.extract_storage(); }
+    };
 public:
     /// Constructs a buffer with enough space to hold the header and `capacity` number of Elements.
     ///
     /// `init_header` must initialize the header by placement new/`std::construct_at` at the supplied memory address.
+    /// The header must report `capacity` as its trailing element count, since the storage is located, resized and
+    /// released by the capacity the header reports.
     [[nodiscard]] static constexpr auto with_header_initialized_by(const Int capacity,
                                                                    std::invocable<Header*> auto&& init_header) noexcept
         -> FlexibleArrayChecked
     {
-        return FlexibleArrayChecked{FlexibleArrayUnchecked<Header, Element>::with_header_initialized_by(capacity, std::forward<decltype(init_header)>(init_header))};
+        return FlexibleArrayChecked{FlexibleArrayUnchecked<Header, Element, Allocator, Layout>::with_header_initialized_by(capacity, std::forward<decltype(init_header)>(init_header))};
     }
 
     /// Constructs a buffer with enough space to hold the header and `capacity` number of Elements.
@@ -38,7 +57,7 @@ public:
     /// Creates an empty FlexibleArrayChecked with no allocated storage.
     [[nodiscard]] static constexpr auto create_empty() noexcept -> FlexibleArrayChecked 
     { 
-        return FlexibleArrayChecked{FlexibleArrayUnchecked<Header, Element>::create_empty()}; 
+        return FlexibleArrayChecked{FlexibleArrayUnchecked<Header, Element, Allocator, Layout>::create_empty()}; 
     }
 
     /// Whether the FlexibleArrayChecked is valid (not moved-from).
@@ -51,10 +70,38 @@ public:
     [[nodiscard]] constexpr auto element_address(this Self&& self, const Int i) noexcept
         -> const_pointee_like<Self, Element*>
     {
-        precondition(i >= 0 && i < self.capacity(), "Index out of bounds");
+        if constexpr (bounds_checks_enabled)
+        {
+            precondition(i >= 0 && i < self.capacity(), "Index out of bounds");
+        }
         return self.unchecked_storage.element_address(i);
     }
 
+    /// Returns the places of the elements at indices [`begin`, `end`), validating the range once.
+    ///
+    /// Accessing the span neither reads the header nor checks bounds, so that a scan over it compiles to plain pointer
+    /// increments. Only the alive elements of the span may be read.
+    /// Requires 0 <= `begin` <= `end` <= `capacity()`, and the object being in a valid, non-moved-from state.
+    template <typename Self>
+    [[nodiscard]] constexpr auto span(this Self&& self, const Int begin, const Int end) noexcept
+        -> std::span<const_like<Self, Element>>
+    {
+        if constexpr (bounds_checks_enabled)
+        {
+            precondition(begin >= 0 && begin <= end && end <= self.capacity(), "Range out of bounds");
+        }
+        return {self.unchecked_storage.element_address(begin), static_cast<size_t>(end - begin)};
+    }
+
+    /// Returns the places of all `capacity()` elements.
+    ///
+    /// Requires the object being in a valid, non-moved-from state.
+    template <typename Self>
+    [[nodiscard]] constexpr auto span(this Self&& self) noexcept -> std::span<const_like<Self, Element>>
+    {
+        return self.span(0, self.capacity());
+    }
+
     /// Returns the pointer to the header.
     ///
     /// Requires the FlexibleArrayChecked being in a valid, non-moved-from state.
@@ -69,10 +116,44 @@ public:
     /// Requires the object to be in a valid, non-moved-from state.
     [[nodiscard]] constexpr auto capacity() const noexcept -> Int { return unchecked_storage.header()->trailing_element_count(); }
 
+    /// Tries to make room for `new_capacity` elements without moving the storage.
+    ///
+    /// On success, the caller must update the header so that it reports `new_capacity` trailing elements.
+    /// Requires the object to be in a valid, non-moved-from state.
+    [[nodiscard]] auto try_grow_in_place(const Int new_capacity) noexcept -> bool
+    {
+        return unchecked_storage.try_grow_in_place(new_capacity);
+    }
+
+    /// Resizes the storage to have room for `new_capacity` elements, moving its bytes if it cannot grow in place.
+    ///
+    /// The caller must update the header afterwards so that it reports `new_capacity` trailing elements.
+    /// Requires the header and the elements alive in the storage to be trivially relocatable, and elements at
+    /// indices `new_capacity` and above to be destroyed.
+    void reallocate(const Int new_capacity) noexcept
+        requires(std::is_trivially_copyable_v<Header>)
+    {
+        precondition(new_capacity >= 0);
+        unchecked_storage.reallocate(new_capacity);
+    }
+
     /// Extracts the storage out of the trailing array, handing out the ownership to the callee.
     ///
     /// The original FlexibleCheckedArray will be left in a moved-from state.
-    [[nodiscard]] constexpr auto extract_storage() -> FlexibleArrayUnchecked<Header, Element> { return std::move(unchecked_storage); }
+    [[nodiscard]] constexpr auto extract_storage() -> FlexibleArrayUnchecked<Header, Element, Allocator, Layout> { return std::move(unchecked_storage); }
+
+    /// Takes the ownership of a storage previously handed out by `FlexibleArrayUnchecked::leak_storage()`.
+    [[nodiscard]] static constexpr auto adopting_storage(const UnsafeMutableRawPointer owned_storage) noexcept
+        -> FlexibleArrayChecked
+    {
+        return FlexibleArrayChecked{FlexibleArrayUnchecked<Header, Element, Allocator, Layout>::adopting_storage(owned_storage)};
+    }
+
+    /// Returns the address of the storage without giving up its ownership.
+    [[nodiscard]] constexpr auto storage_address() const noexcept -> UnsafeMutableRawPointer
+    {
+        return unchecked_storage.storage_address();
+    }
 
     // Not copyable
     FlexibleArrayChecked(const FlexibleArrayChecked& other) = delete;
@@ -89,18 +170,37 @@ public:
         swap(a.unchecked_storage, b.unchecked_storage);
     }
 
-    /// Projects a stack-allocated temporary
-    template <std::invocable<FlexibleArrayChecked&> F>
+    /// Projects a temporary, which is stack-allocated unless its storage is bigger than `stack_budget` bytes.
+    ///
+    /// Temporaries over the budget are allocated on the heap and freed when `consumer` returns.
+    template <size_t stack_budget = default_temporary_stack_budget, std::invocable<FlexibleArrayChecked&> F>
     static constexpr auto project_temporary(const Int element_count, F consumer) -> std::invoke_result_t<F, FlexibleArrayChecked&>
     {
-        return FlexibleArrayUnchecked<Header, Element>::project_temporary(element_count, [&](auto& unchecked) {
+        precondition(element_count >= 0);
+        using Unchecked = FlexibleArrayUnchecked<Header, Element, Allocator, Layout>;
+        return Unchecked::template project_temporary<stack_budget>(element_count, [&](auto& unchecked) {
             // Wrap the unchecked version in a checked wrapper (consume the projected `unchecked` temporarily).
             FlexibleArrayChecked checked{std::move(unchecked)};
-            auto result = consumer(checked);
+            const ProjectionRestorer restorer{checked, unchecked};
+            return consumer(checked);
+        });
+    }
 
-            // After the consumer is done with it, move out the unchecked storage to restore the projection.
-            unchecked = checked.extract_storage();
-            return result;
+    /// Projects a temporary allocated from the ScratchArena of the current thread, released when `consumer` returns or
+    /// throws.
+    ///
+    /// `consumer` may project further temporaries, but must not suspend while other code on the same thread uses the
+    /// arena.
+    template <std::invocable<FlexibleArrayChecked&> F>
+    static auto project_scratch_temporary(const Int element_count, F consumer)
+        -> std::invoke_result_t<F, FlexibleArrayChecked&>
+    {
+        precondition(element_count >= 0);
+        using Unchecked = FlexibleArrayUnchecked<Header, Element, Allocator, Layout>;
+        return Unchecked::project_scratch_temporary(element_count, [&](auto& unchecked) {
+            FlexibleArrayChecked checked{std::move(unchecked)};
+            const ProjectionRestorer restorer{checked, unchecked};
+            return consumer(checked);
         });
     }
 };
@@ -0,0 +1,259 @@
+#ifndef CPP_MVS_FLEXIBLE_ARRAY_MULTI_HPP
+#define CPP_MVS_FLEXIBLE_ARRAY_MULTI_HPP
+
+#include <array>
+#include <tuple>
+#include <utility>
+#include "allocation_tracking.hpp"
+#include "library.h"
+
+/// A buffer of a header followed by one trailing array per type in `Elements`, in a single allocation.
+///
+/// The arrays follow each other in the order of `Elements`, each aligned to its element type, so that a
+/// struct-of-arrays layout (e.g. keys, values and metadata) takes one allocation and a scan over one of the arrays
+/// touches only its own cache lines. The number of elements of each array is reported by the header.
+///
+/// Like FlexibleArrayUnchecked, the buffer is **movable** but **not copyable**, manages the lifetime of the header
+/// but not of the elements, and acquires its storage from `Allocator`, recording it when allocations are tracked.
+/// Element access is bounds-checked.
+template <StorageAllocator Allocator, typename Header, typename... Elements>
+    requires(sizeof...(Elements) > 0) && TrailingElementCountsProvider<Header, sizeof...(Elements)>
+class AllocatedFlexibleArrayMulti
+{
+public:
+    /// The number of trailing arrays.
+    static constexpr size_t array_count = sizeof...(Elements);
+
+    /// The element counts of the trailing arrays.
+    using Counts = std::array<Int, array_count>;
+
+    /// The element type of the `I`th trailing array.
+    template <size_t I>
+    using ElementAt = std::tuple_element_t<I, std::tuple<Elements...>>;
+
+private:
+    /// Storage containing Header, then each trailing array preceded by its alignment padding.
+    ///
+    /// May be null in case of a moved-from object.
+    UnsafeMutableRawPointer storage;
+
+    static constexpr std::array<size_t, array_count> element_sizes = {sizeof(Elements)...};
+    static constexpr std::array<size_t, array_count> element_alignments = {alignof(Elements)...};
+
+    /// The offsets of the trailing arrays from the start of the storage, followed by the total storage size, given in
+    /// bytes.
+    ///
+    /// The total size is a multiple of `storage_alignment()`.
+    [[nodiscard]] static constexpr auto layout_for(const Counts& counts) noexcept -> std::array<size_t, array_count + 1>
+    {
+        std::array<size_t, array_count + 1> offsets{};
+        size_t end = sizeof(Header);
+        for (size_t i = 0; i < array_count; ++i)
+        {
+            offsets[i] = align_up(end, element_alignments[i]);
+            end = offsets[i] + (element_sizes[i] * static_cast<size_t>(counts[i]));
+        }
+        offsets[array_count] = align_up(end, storage_alignment());
+        return offsets;
+    }
+
+    /// The offset of the `I`th trailing array from the start of the storage, given in bytes.
+    ///
+    /// Lays out only the arrays before it, which is free for the first array.
+    template <size_t I>
+    [[nodiscard]] static constexpr auto offset_for(const Counts& counts) noexcept -> size_t
+    {
+        size_t end = sizeof(Header);
+        for (size_t i = 0; i < I; ++i)
+        {
+            end = align_up(end, element_alignments[i]) + (element_sizes[i] * static_cast<size_t>(counts[i]));
+        }
+        return align_up(end, element_alignments[I]);
+    }
+
+    /// The shape of a storage of `size` bytes with `counts` elements, as recorded by the allocation tracking.
+    ///
+    /// The arrays are recorded as one array of bytes, so that the padding between them counts as padding.
+    [[nodiscard]] static constexpr auto storage_shape(const Counts& counts) noexcept -> AllocationTracking::StorageShape
+    {
+        Int element_bytes = 0;
+        for (size_t i = 0; i < array_count; ++i)
+        {
+            element_bytes += static_cast<Int>(element_sizes[i]) * counts[i];
+        }
+        return {sizeof(Header), 1, element_bytes};
+    }
+
+    /// The alignment of the storage, suitable for the header and all elements.
+    [[nodiscard]] static constexpr auto storage_alignment() noexcept -> size_t
+    {
+        return std::max({alignof(Header), alignof(Elements)...});
+    }
+
+    /// Destroys the header and returns the storage to the allocator.
+    ///
+    /// Requires the object being in a valid, non-moved-from state.
+    void destroy_storage() noexcept
+    {
+        const Counts counts = header()->trailing_element_counts();
+        const auto storage_size = layout_for(counts)[array_count];
+        std::destroy_at(header());
+        Allocator::deallocate(storage, storage_size, storage_alignment());
+        if constexpr (allocation_tracking_enabled)
+        {
+            AllocationTracking::record_deallocation(storage_shape(counts), storage_size);
+        }
+    }
+
+    /// Constructs a flexible array by taking ownership of an existing storage.
+    [[nodiscard]] constexpr explicit AllocatedFlexibleArrayMulti(char* const owned_storage) noexcept :
+        storage(owned_storage)
+    {
+    }
+
+public:
+    /// Constructs a buffer with enough space to hold the header and `counts[i]` elements in the `i`th array.
+    ///
+    /// `init_header` must initialize the header by placement new/std::construct_at at the supplied memory address,
+    /// so that it reports `counts`.
+    [[nodiscard]] static auto with_header_initialized_by(const Counts& counts,
+                                                         std::invocable<Header*> auto&& init_header) noexcept
+        -> AllocatedFlexibleArrayMulti
+    {
+        for (const Int count : counts)
+        {
+            precondition(count >= 0);
+        }
+        const auto storage_size = layout_for(counts)[array_count];
+        auto* storage = static_cast<char*>(Allocator::allocate(storage_size, storage_alignment()));
+        precondition(storage != nullptr, "Out of memory");
+        if constexpr (allocation_tracking_enabled)
+        {
+            AllocationTracking::record_allocation(storage_shape(counts), storage_size);
+        }
+        init_header(reinterpret_cast<Header*>(storage));
+        return AllocatedFlexibleArrayMulti{storage};
+    }
+
+    /// Constructs a buffer with enough space for the element counts reported by `header`.
+    ///
+    /// The given `header` is moved into the storage.
+    [[nodiscard]] static auto with_header(Header&& header) noexcept -> AllocatedFlexibleArrayMulti
+        requires(std::movable<Header>)
+    {
+        return with_header_initialized_by(header.trailing_element_counts(),
+                                          [&](Header* place) { std::construct_at(place, std::move(header)); });
+    }
+
+    /// Creates an empty AllocatedFlexibleArrayMulti with no allocated storage.
+    [[nodiscard]] static constexpr auto create_empty() noexcept -> AllocatedFlexibleArrayMulti
+    {
+        return AllocatedFlexibleArrayMulti{nullptr};
+    }
+
+    /// Whether the AllocatedFlexibleArrayMulti is valid (not moved-from).
+    [[nodiscard]] constexpr auto is_valid() const noexcept -> bool { return storage != nullptr; }
+
+    /// Returns the pointer to the header.
+    ///
+    /// Requires the object being in a valid, non-moved-from state.
+    template <typename Self>
+    [[nodiscard]] constexpr auto header(this Self&& self) noexcept -> const_pointee_like<Self, Header*>
+    {
+        return reinterpret_cast<const_pointee_like<Self, Header*>>(self.storage);
+    }
+
+    /// The number of elements of the `I`th array.
+    ///
+    /// Requires the object being in a valid, non-moved-from state.
+    template <size_t I>
+    [[nodiscard]] constexpr auto count() const noexcept -> Int
+    {
+        return header()->trailing_element_counts()[I];
+    }
+
+    /// Returns the address of the first element of the `I`th array.
+    ///
+    /// Note: There may be no element at the returned address when `count<I>() == 0`. Scanning an array through this
+    /// address avoids recomputing the layout for every element.
+    /// Requires the object being in a valid, non-moved-from state.
+    template <size_t I, typename Self>
+    [[nodiscard]] constexpr auto elements_start(this Self&& self) noexcept
+        -> const_pointee_like<Self, ElementAt<I>*>
+    {
+        const auto offset = offset_for<I>(self.header()->trailing_element_counts());
+        return reinterpret_cast<const_pointee_like<Self, ElementAt<I>*>>(self.storage + offset);
+    }
+
+    /// Returns the addresses of the first elements of all arrays, in the order of `Elements`.
+    ///
+    /// Lays out the storage once, so that code accessing several arrays does not repeat it per array.
+    /// Requires the object being in a valid, non-moved-from state.
+    template <typename Self>
+    [[nodiscard]] constexpr auto all_elements_start(this Self&& self) noexcept
+        -> std::tuple<const_pointee_like<Self, Elements*>...>
+    {
+        const auto offsets = layout_for(self.header()->trailing_element_counts());
+        return [&]<size_t... indices>(std::index_sequence<indices...>)
+        {
+            return std::tuple<const_pointee_like<Self, Elements*>...>{
+                reinterpret_cast<const_pointee_like<Self, Elements*>>(self.storage + offsets[indices])...};
+        }(std::index_sequence_for<Elements...>{});
+    }
+
+    /// Returns the address for the place of the `i`th element of the `I`th array.
+    ///
+    /// Requires 0 <= `i` < `count<I>()`, and the object being in a valid, non-moved-from state.
+    template <size_t I, typename Self>
+    [[nodiscard]] constexpr auto element_address(this Self&& self, const Int i) noexcept
+        -> const_pointee_like<Self, ElementAt<I>*>
+    {
+        precondition(i >= 0 && i < self.template count<I>(), "Index out of bounds");
+        return self.template elements_start<I>() + i;
+    }
+
+    /// Destroying the header unless the object is in a moved-from state.
+    ~AllocatedFlexibleArrayMulti()
+    {
+        if (storage != nullptr)
+        {
+            destroy_storage();
+        }
+    }
+
+    // Not copyable
+    AllocatedFlexibleArrayMulti(const AllocatedFlexibleArrayMulti& other) = delete;
+    AllocatedFlexibleArrayMulti& operator=(const AllocatedFlexibleArrayMulti& other) = delete;
+
+    /// Move constructor
+    AllocatedFlexibleArrayMulti(AllocatedFlexibleArrayMulti&& other) noexcept :
+        storage(std::exchange(other.storage, nullptr))
+    {
+    }
+
+    /// Move assignment operator
+    AllocatedFlexibleArrayMulti& operator=(AllocatedFlexibleArrayMulti&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (storage != nullptr)
+            {
+                destroy_storage();
+            }
+            storage = std::exchange(other.storage, nullptr);
+        }
+        return *this;
+    }
+
+    /// Swaps the underlying storage of `a` and `b`.
+    friend void swap(AllocatedFlexibleArrayMulti& a, AllocatedFlexibleArrayMulti& b) noexcept
+    {
+        std::swap(a.storage, b.storage);
+    }
+};
+
+/// An AllocatedFlexibleArrayMulti acquiring its storage from the DefaultAllocator.
+template <typename Header, typename... Elements>
+using FlexibleArrayMulti = AllocatedFlexibleArrayMulti<DefaultAllocator, Header, Elements...>;
+
+#endif // CPP_MVS_FLEXIBLE_ARRAY_MULTI_HPP
@@ -1,7 +1,9 @@
 #ifndef CPP_MVS_FLEXIBLE_ARRAY_UNCHECKED_HPP
 #define CPP_MVS_FLEXIBLE_ARRAY_UNCHECKED_HPP
 
+#include "allocation_tracking.hpp"
 #include "library.h"
+#include "scratch_arena.hpp"
 
 /// A buffer of header and elements stored in a contiguous region of memory, whose size is determined at
 /// instance creation.
@@ -14,54 +16,141 @@
 ///   be stored in its payload. You must ensure that they are properly destroyed before destroying this object.
 ///   Similarly, the initialization of `FlexibleArray` doesn't start the lifetime of its elements, so users must
 ///   use placement new or std::construct_at to create the object.
-template <TrailingElementCountProvider Header, typename Element>
+///
+/// The storage is acquired from and returned to `Allocator`, and the header is placed before or after the elements
+/// as `Layout` decides.
+template <TrailingElementCountProvider Header, typename Element, StorageAllocator Allocator = DefaultAllocator,
+          StorageLayoutPolicy Layout = HeaderFirstLayout>
 struct FlexibleArrayUnchecked
 {
+public:
+    /// The layout of the storage.
+    static constexpr StorageLayoutDescriptor layout =
+        StorageLayoutDescriptor::of<Header, Element>(Layout::template header_placement<Header, Element>());
+
 private:
-    /// Storage containing Header, potential padding, then `capacity` number of elements.
+    /// Storage containing Header and `capacity` number of elements in the order given by `layout`, with potential
+    /// padding between them. Points to `layout.pointer_offset(capacity)` bytes after the start of the storage: to the
+    /// first element if the header precedes the elements, or to the header otherwise.
     ///
     /// May be null in case of a moved-from object.
     UnsafeMutableRawPointer storage;
 
-    /// The offset of the start of the array from the start of the storage, given in bytes.
-    [[nodiscard]] static constexpr auto elements_offset() noexcept -> Int
-    {
-        return align_up(sizeof(Header), alignof(Element));
-    }
-
     /// The total space required for the storage of `element_count` elements, given in bytes.
     ///
     /// Guaranteed to be a multiple of `Header`'s alignment.
     [[nodiscard]] static constexpr auto storage_size_for(const Int element_count) noexcept -> size_t
     {
-        return align_up(static_cast<size_t>(elements_offset() + (sizeof(Element) * element_count)), alignof(Header));
+        return layout.storage_size(element_count);
+    }
+
+    /// The alignment of the storage, suitable for both the header and the elements.
+    [[nodiscard]] static constexpr auto storage_alignment() noexcept -> size_t { return layout.alignment(); }
+
+    /// The start of the storage for `capacity` elements that `pointer` points into, as described at `storage`.
+    [[nodiscard]] static constexpr auto storage_start(const UnsafeMutableRawPointer pointer, const Int capacity) noexcept
+        -> UnsafeMutableRawPointer
+    {
+        return pointer - layout.pointer_offset(capacity);
+    }
+
+    /// Moves a trailing header within `block` from its place for `old_capacity` elements to its place for
+    /// `new_capacity` elements.
+    static void move_trailing_header(const UnsafeMutableRawPointer block, const Int old_capacity,
+                                     const Int new_capacity) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<Header>, "A trailing header is moved by copying its bytes");
+        std::memmove(block + layout.header_offset(new_capacity), block + layout.header_offset(old_capacity),
+                     sizeof(Header));
+    }
+
+    /// The shape of a storage for `capacity` elements, as recorded by the allocation tracking.
+    [[nodiscard]] static constexpr auto storage_shape(const Int capacity) noexcept -> AllocationTracking::StorageShape
+    {
+        return {sizeof(Header), sizeof(Element), capacity};
+    }
+
+    /// Records resizing the storage from `old_capacity` to `new_capacity` elements, if allocations are tracked.
+    static void track_resize(const Int old_capacity, const Int new_capacity) noexcept
+    {
+        if constexpr (allocation_tracking_enabled)
+        {
+            AllocationTracking::record_deallocation(storage_shape(old_capacity), storage_size_for(old_capacity));
+            AllocationTracking::record_allocation(storage_shape(new_capacity), storage_size_for(new_capacity));
+        }
+    }
+
+    /// Destroys the header and returns the storage to the allocator.
+    ///
+    /// Requires the object being in a valid, non-moved-from state.
+    void destroy_storage() noexcept
+    {
+        const Int capacity = header()->trailing_element_count();
+        const auto storage_size = storage_size_for(capacity);
+        std::destroy_at(header());
+        Allocator::deallocate(storage_start(storage, capacity), storage_size, storage_alignment());
+        if constexpr (allocation_tracking_enabled)
+        {
+            AllocationTracking::record_deallocation(storage_shape(capacity), storage_size);
+        }
     }
 
     /// Constructs a flexible array by taking ownership of an existing storage.
     [[nodiscard]] constexpr explicit FlexibleArrayUnchecked(char* const owned_storage) noexcept : storage(owned_storage) {}
 
+    /// Ends the projection of a temporary whose storage the flexible array does not own: destroys the header and leaks
+    /// the storage, also when the consumer throws, so that the storage is only released by its actual owner.
+    struct ProjectionEnd
+    {
+        FlexibleArrayUnchecked& flexible_array;
+
+        ~ProjectionEnd()
+        {
+            std::destroy_at(flexible_array.header());
+            static_cast<void>(flexible_array.leak_storage());
+        }
+    };
+
     /// Returns the address of the first array element.
     ///
-    /// Note: There may be no element at the returned address when `capacity() == 0`.
+    /// Note: There may be no element at the returned address when `capacity() == 0`. With a trailing header, the
+    /// address is computed from the capacity reported by the header.
     /// Requires the object being in a valid, non-moved-from state.
     template <typename Self>
     [[nodiscard]] constexpr auto elements_start(this Self&& self) -> const_pointee_like<Self, Element*>
     {
-        return reinterpret_cast<const_pointee_like<Self, Element*>>(self.storage + elements_offset());
+        if constexpr (layout.header_placement == HeaderPlacement::leading)
+        {
+            return reinterpret_cast<const_pointee_like<Self, Element*>>(self.storage + layout.elements_offset());
+        }
+        else if constexpr (layout.header_placement == HeaderPlacement::preceding_elements)
+        {
+            return reinterpret_cast<const_pointee_like<Self, Element*>>(self.storage);
+        }
+        else
+        {
+            return reinterpret_cast<const_pointee_like<Self, Element*>>(
+                storage_start(self.storage, self.header()->trailing_element_count()));
+        }
     }
 
 public:
     /// Constructs a buffer with enough space to hold the header and `capacity` number of Elements.
     ///
     /// `init_header` must initialize the header by placement new/std::construct_at at the supplied memory address.
+    /// The header must report `capacity` as its trailing element count, since the storage is located, resized and
+    /// released by the capacity the header reports.
     [[nodiscard]] static constexpr auto with_header_initialized_by(Int const capacity,
                                                                    std::invocable<Header*> auto&& init_header) noexcept
         -> FlexibleArrayUnchecked
     {
-        auto* storage = static_cast<char*>(
-            Detail::aligned_alloc(storage_size_for(capacity), std::max(alignof(Header), alignof(Element))));
-        init_header(reinterpret_cast<Header*>(storage));
-        return FlexibleArrayUnchecked{storage};
+        auto* storage = static_cast<char*>(Allocator::allocate(storage_size_for(capacity), storage_alignment()));
+        if constexpr (allocation_tracking_enabled)
+        {
+            AllocationTracking::record_allocation(storage_shape(capacity), storage_size_for(capacity));
+        }
+        init_header(reinterpret_cast<Header*>(storage + layout.header_offset(capacity)));
+        return FlexibleArrayUnchecked{storage + layout.pointer_offset(capacity)};
     }
 
     /// Constructs a buffer with enough space to hold the header and `capacity` number of Elements.
@@ -96,7 +185,14 @@ public:
     template <typename Self>
     [[nodiscard]] constexpr auto header(this Self&& self) noexcept -> const_pointee_like<Self, Header*>
     {
-        return reinterpret_cast<const_pointee_like<Self, Header*>>(self.storage);
+        if constexpr (layout.header_placement == HeaderPlacement::preceding_elements)
+        {
+            return reinterpret_cast<const_pointee_like<Self, Header*>>(self.storage - sizeof(Header));
+        }
+        else
+        {
+            return reinterpret_cast<const_pointee_like<Self, Header*>>(self.storage);
+        }
     }
 
     /// Destroying the header unless the object is in a moved-from state.
@@ -104,9 +200,88 @@ public:
     {
         if (storage != nullptr)
         {
-            std::destroy_at(header());
-            Detail::aligned_free(storage);
+            destroy_storage();
+        }
+    }
+
+    /// Tries to make room for `new_capacity` elements without moving the storage.
+    ///
+    /// On success, the caller must update the header so that it reports `new_capacity` trailing elements.
+    /// Requires the object being in a valid, non-moved-from state, and a trailing header to be trivially copyable.
+    [[nodiscard]] auto try_grow_in_place(const Int new_capacity) noexcept -> bool
+    {
+        if constexpr (ResizingStorageAllocator<Allocator>)
+        {
+            const Int old_capacity = header()->trailing_element_count();
+            auto* const block = storage_start(storage, old_capacity);
+            if (!Allocator::try_expand_in_place(block, storage_size_for(new_capacity)))
+            {
+                return false;
+            }
+            if constexpr (layout.header_placement == HeaderPlacement::trailing)
+            {
+                move_trailing_header(block, old_capacity, new_capacity);
+                storage = block + layout.pointer_offset(new_capacity);
+            }
+            track_resize(old_capacity, new_capacity);
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /// Resizes the storage to have room for `new_capacity` elements, moving its bytes if it cannot grow in place.
+    ///
+    /// The caller must update the header afterwards so that it reports `new_capacity` trailing elements.
+    /// Requires the header and the elements alive in the storage to be trivially relocatable, elements at indices
+    /// `new_capacity` and above to be destroyed, and the object being in a valid, non-moved-from state.
+    void reallocate(const Int new_capacity) noexcept
+        requires(std::is_trivially_copyable_v<Header>)
+    {
+        if (try_grow_in_place(new_capacity))
+        {
+            return;
+        }
+        const Int old_capacity = header()->trailing_element_count();
+        const auto old_size = storage_size_for(old_capacity);
+        const auto new_size = storage_size_for(new_capacity);
+        auto* const old_storage = storage_start(storage, old_capacity);
+        constexpr bool is_header_trailing = layout.header_placement == HeaderPlacement::trailing;
+        // A trailing header is moved to its new place within the bigger of the old and the new storage, so that
+        // the resize preserves it.
+        if constexpr (is_header_trailing)
+        {
+            if (new_capacity < old_capacity)
+            {
+                move_trailing_header(old_storage, old_capacity, new_capacity);
+            }
+        }
+        void* new_storage = nullptr;
+        if constexpr (ResizingStorageAllocator<Allocator>)
+        {
+            new_storage = Allocator::reallocate(old_storage, old_size, new_size, storage_alignment());
+        }
+        else
+        {
+            new_storage = Allocator::allocate(new_size, storage_alignment());
+            if (new_storage != nullptr)
+            {
+                std::memcpy(new_storage, old_storage, std::min(old_size, new_size));
+                Allocator::deallocate(old_storage, old_size, storage_alignment());
+            }
+        }
+        precondition(new_storage != nullptr, "Out of memory");
+        if constexpr (is_header_trailing)
+        {
+            if (new_capacity > old_capacity)
+            {
+                move_trailing_header(static_cast<char*>(new_storage), old_capacity, new_capacity);
+            }
         }
+        storage = static_cast<char*>(new_storage) + layout.pointer_offset(new_capacity);
+        track_resize(old_capacity, new_capacity);
     }
 
     /// Extracts the storage out of the trailing array, handing out the ownership to the callee.
@@ -114,6 +289,20 @@ public:
     /// The underlying storage won't be freed by this FlexibleArray.
     [[nodiscard]] constexpr auto leak_storage() -> UnsafeMutableRawPointer { return std::exchange(storage, nullptr); }
 
+    /// Takes the ownership of a storage previously handed out by `leak_storage()`.
+    [[nodiscard]] static constexpr auto adopting_storage(const UnsafeMutableRawPointer owned_storage) noexcept
+        -> FlexibleArrayUnchecked
+    {
+        return FlexibleArrayUnchecked{owned_storage};
+    }
+
+    /// Returns the address of the storage without giving up its ownership.
+    ///
+    /// This is the address of the first element if the header precedes the elements, and of the header otherwise.
+    /// Together with `adopting_storage()` and `leak_storage()`, this lets several owners share a storage, e.g. by
+    /// keeping a reference count in the header.
+    [[nodiscard]] constexpr auto storage_address() const noexcept -> UnsafeMutableRawPointer { return storage; }
+
     // Not copyable
     FlexibleArrayUnchecked(const FlexibleArrayUnchecked& other) = delete;
     FlexibleArrayUnchecked& operator=(const FlexibleArrayUnchecked& other) = delete;
@@ -131,8 +320,7 @@ public:
         // Destroying the header unless the object was in a moved-from state.
         if (storage != nullptr)
         {
-            std::destroy_at(header());
-            Detail::aligned_free(storage);
+            destroy_storage();
         }
         // Taking ownership of the other object's storage, marking the other object as moved-from.
         storage = other.storage;
@@ -143,19 +331,64 @@ public:
     /// Swaps the underlying storage of `a` and `b`.
     friend void swap(FlexibleArrayUnchecked& a, FlexibleArrayUnchecked& b) noexcept { std::swap(a.storage, b.storage); }
 
-    /// Projects a stack-allocated temporary
-    template <std::invocable<FlexibleArrayUnchecked&> F>
+    /// Projects a temporary, which is stack-allocated unless its storage is bigger than `stack_budget` bytes.
+    ///
+    /// Temporaries over the budget are allocated on the heap and freed when `consumer` returns or throws, so that
+    /// element counts coming from runtime data cannot overflow the stack. `consumer` must construct the header before
+    /// anything it does can throw.
+    template <size_t stack_budget = default_temporary_stack_budget, std::invocable<FlexibleArrayUnchecked&> F>
     static constexpr auto project_temporary(Int element_count, F consumer) -> std::invoke_result_t<F, FlexibleArrayUnchecked&>
     {
+        /// Owns the heap-allocated storage of a temporary over the budget, and frees it also when the consumer throws.
+        struct HeapStorageOwner
+        {
+            char* block;
+
+            ~HeapStorageOwner() { Detail::aligned_free(block); }
+        };
+
         auto storage_size = FlexibleArrayUnchecked::storage_size_for(element_count);
-        char* storage = aligned_alloca(storage_size, alignof(Header));
+        const bool is_on_stack = storage_size <= stack_budget;
+        char* storage = is_on_stack
+                            ? aligned_alloca(storage_size, storage_alignment())
+                            : static_cast<char*>(Detail::aligned_alloc(storage_size, storage_alignment()));
+        precondition(storage != nullptr, "Out of memory");
+        const HeapStorageOwner heap_storage_owner{is_on_stack ? nullptr : storage};
+        storage += layout.pointer_offset(element_count);
+        if constexpr (allocation_tracking_enabled)
+        {
+            using enum AllocationTracking::TemporaryPlacement;
+            AllocationTracking::record_temporary(storage_size, is_on_stack ? stack : heap);
+        }
 
         FlexibleArrayUnchecked flexible_array{storage};
-        auto result = consumer(flexible_array);
+        const ProjectionEnd projection_end{flexible_array};
+        return consumer(flexible_array);
+    }
 
-        std::destroy_at(reinterpret_cast<Header*>(flexible_array.leak_storage()));
+    /// Projects a temporary allocated from the ScratchArena of the current thread, released when `consumer` returns or
+    /// throws. `consumer` must construct the header before anything it does can throw.
+    ///
+    /// Never uses the call stack, so it suits big temporaries, deep recursion and coroutine frames, and costs no
+    /// malloc once the arena has grown to the working set of the thread. `consumer` may project further temporaries,
+    /// but must not suspend while other code on the same thread uses the arena.
+    template <std::invocable<FlexibleArrayUnchecked&> F>
+    static auto project_scratch_temporary(Int element_count, F consumer)
+        -> std::invoke_result_t<F, FlexibleArrayUnchecked&>
+    {
+        ScratchArena& arena = ScratchArena::for_current_thread();
+        const ScratchArena::Scope scope{arena};
+        auto storage_size = FlexibleArrayUnchecked::storage_size_for(element_count);
+        auto* storage = static_cast<char*>(arena.allocate(storage_size, storage_alignment())) +
+                        layout.pointer_offset(element_count);
+        if constexpr (allocation_tracking_enabled)
+        {
+            AllocationTracking::record_temporary(storage_size, AllocationTracking::TemporaryPlacement::scratch_arena);
+        }
 
-        return result;
+        FlexibleArrayUnchecked flexible_array{storage};
+        const ProjectionEnd projection_end{flexible_array};
+        return consumer(flexible_array);
     }
 };
 
@@ -1,4 +1,10 @@
 #include "library.h"
 
 #include <iostream>
+#include <print>
 
+void Detail::precondition_failure(const char* const message) noexcept
+{
+    std::println("Assertion failure: {}\n", message);
+    std::quick_exit(EXIT_FAILURE);
+}
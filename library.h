@@ -1,11 +1,16 @@
 #ifndef CPP_MVS_LIBRARY_H
 #define CPP_MVS_LIBRARY_H
 
+#include <algorithm>
+#include <array>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
-#include <print>
+#include <span>
 #include <string_view>
 #include <type_traits>
 #include <utility>
@@ -19,7 +24,10 @@ namespace Detail
 #ifdef _MSC_VER
         return _aligned_malloc(size, align);
 #else
-        return std::aligned_alloc(align, size);
+        // Unlike aligned_alloc, posix_memalign accepts sizes that are not a multiple of the alignment, such as the
+        // size of a storage whose header trails over-aligned elements.
+        void* block = nullptr;
+        return posix_memalign(&block, std::max(align, sizeof(void*)), size) == 0 ? block : nullptr;
 #endif
     }
 
@@ -29,6 +37,32 @@ namespace Detail
         _aligned_free(block);
 #else
         std::free(block);
+#endif
+    }
+
+    /// Resizes a block returned by `aligned_alloc` to `new_size` bytes, preserving its first `old_size` bytes.
+    ///
+    /// Uses `realloc` when the alignment allows it, which extends the block in place whenever the heap can, and glibc
+    /// serves large blocks with mmap and grows them with mremap, so such buffers are neither copied nor held twice at
+    /// the peak. Over-aligned blocks have no aligned counterpart of `realloc` outside MSVC, so they are always copied
+    /// into a new block. Returns null, leaving the block intact, when there is not enough memory.
+    inline void* aligned_realloc(void* block, size_t old_size, size_t new_size, size_t align)
+    {
+#ifdef _MSC_VER
+        (void)old_size;
+        return _aligned_realloc(block, new_size, align);
+#else
+        if (align <= alignof(std::max_align_t))
+        {
+            return std::realloc(block, new_size);
+        }
+        void* new_block = aligned_alloc(new_size, align);
+        if (new_block != nullptr)
+        {
+            std::memcpy(new_block, block, std::min(old_size, new_size));
+            aligned_free(block);
+        }
+        return new_block;
 #endif
     }
 } // namespace Detail
@@ -45,15 +79,79 @@ using const_pointee_like = std::conditional_t<std::is_const_v<std::remove_refere
                                               // If Base is not const: keep original
                                               TargetType>;
 
-constexpr void precondition(const bool p, const std::string_view message = "Precondition failure.")
+/// Marks a function as rarely called, so that the compiler places it apart from the hot code and treats branches to it
+/// as unlikely. Expands to nothing with MSVC, which has no such attribute.
+#ifdef _MSC_VER
+#define CPP_MVS_COLD
+#else
+#define CPP_MVS_COLD [[gnu::cold]]
+#endif
+
+namespace Detail
 {
-    if (!p)
+    /// Reports the failure of a precondition described by the null-terminated `message`, and terminates the program.
+    ///
+    /// Defined out of line and marked cold, so that a check inlined into a hot loop compiles to a compare and a
+    /// branch to a call, keeping the formatting code out of the loop and of the instruction cache.
+    [[noreturn]] CPP_MVS_COLD void precondition_failure(const char* message) noexcept;
+} // namespace Detail
+
+/// Terminates the program with the null-terminated `message` unless `p` holds.
+///
+/// The message is a single pointer, measuring its length only on failure, so that GCC sinks the failure call out of
+/// loops rather than setting up a string_view inside them.
+constexpr void precondition(const bool p, const char* const message = "Precondition failure.")
+{
+    if (!p) [[unlikely]]
     {
-        std::println("Assertion failure: {}\n", message);
-        std::quick_exit(EXIT_FAILURE);
+        Detail::precondition_failure(message);
     }
 }
 
+/// How checked containers validate the indices of element accesses.
+enum class BoundsChecking
+{
+    /// Every access is validated.
+    checked,
+    /// Accesses are not validated.
+    unchecked,
+};
+
+/// The bounds checking of the build, set by defining `CPP_MVS_BOUNDS_CHECKS` to the name of a BoundsChecking
+/// enumerator, e.g. `-DCPP_MVS_BOUNDS_CHECKS=unchecked`. Defaults to `checked`.
+///
+/// The policy must be the same in every translation unit, as the checked containers are inline, so it depends on no
+/// other macro, such as `NDEBUG`. The build resolves per-configuration policies instead: the CMake option
+/// `CPP_MVS_BOUNDS_CHECKS=debug_only` defines `checked` for Debug builds and `unchecked` for the others.
+#ifdef CPP_MVS_BOUNDS_CHECKS
+inline constexpr BoundsChecking bounds_checking = BoundsChecking::CPP_MVS_BOUNDS_CHECKS;
+#else
+inline constexpr BoundsChecking bounds_checking = BoundsChecking::checked;
+#endif
+
+/// Whether checked containers validate the indices of element accesses in this build.
+inline constexpr bool bounds_checks_enabled = bounds_checking == BoundsChecking::checked;
+
+/// Whether a `T` can be moved to another address by copying its bytes and forgetting the original, which is then
+/// equivalent to move-constructing the copy and destroying the original.
+///
+/// Holds for trivially copyable types. Specialize it to opt in types whose moves only copy and clear their fields, and
+/// whose destructors do nothing to moved-from objects, such as `std::unique_ptr`, so that containers move them with
+/// `memmove` instead of one element at a time.
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+{
+};
+
+/// A unique pointer is relocated by copying its pointer, and its deleter if that can be.
+template <typename T, typename Deleter>
+struct is_trivially_relocatable<std::unique_ptr<T, Deleter>> : is_trivially_relocatable<Deleter>
+{
+};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<std::remove_cv_t<T>>::value;
+
 /// Rounds up 'n' to the next multiple of 'align', assuming `n` and `align` are non-negative integer powers of 2.
 template <std::unsigned_integral T>
 constexpr auto align_up(const T n, T const align) -> T
@@ -66,14 +164,226 @@ constexpr auto align_up(const T n, T const align) -> T
     reinterpret_cast<char*>(                                                                                           \
         ::align_up(reinterpret_cast<uintptr_t>(alloca((size) + (alignment))), static_cast<uintptr_t>(alignment)))
 
+/// The default size, given in bytes, up to which `project_temporary` places temporaries on the stack.
+///
+/// Bigger temporaries are allocated on the heap. Can be overridden by defining `CPP_MVS_TEMPORARY_STACK_BUDGET`.
+#ifdef CPP_MVS_TEMPORARY_STACK_BUDGET
+inline constexpr size_t default_temporary_stack_budget = CPP_MVS_TEMPORARY_STACK_BUDGET;
+#else
+inline constexpr size_t default_temporary_stack_budget = size_t{16} * 1024;
+#endif
+
 template <typename T>
 concept TrailingElementCountProvider = requires(T&& a) {
     /// fun trailing_element_count() -> Int
     { a.trailing_element_count() } -> std::same_as<Int>;
 };
 
+/// A header of a storage with several trailing arrays, reporting the number of elements of each.
+template <typename T, size_t array_count>
+concept TrailingElementCountsProvider = requires(T&& a) {
+    /// fun trailing_element_counts() -> std::array<Int, array_count>
+    { a.trailing_element_counts() } -> std::same_as<std::array<Int, array_count>>;
+};
+
 using UnsafeMutableRawPointer = char*;
 
+/// A strategy for acquiring and releasing the storage of flexible arrays.
+///
+/// Allocators are stateless policies: a flexible array stores nothing but its storage pointer, so any state an
+/// allocator needs (an arena, a pool) must be reachable through static or thread-local members.
+template <typename A>
+concept StorageAllocator = requires(void* block, size_t size, size_t alignment) {
+    /// static fun allocate(size: size_t, alignment: size_t) -> void*
+    { A::allocate(size, alignment) } -> std::same_as<void*>;
+    /// static fun deallocate(block: void*, size: size_t, alignment: size_t)
+    ///
+    /// Receives the same `size` and `alignment` that the block was allocated with.
+    { A::deallocate(block, size, alignment) } -> std::same_as<void>;
+};
+
+/// A StorageAllocator that can also resize its blocks, possibly without moving them.
+template <typename A>
+concept ResizingStorageAllocator = StorageAllocator<A> && requires(void* block, size_t size, size_t alignment) {
+    /// static fun reallocate(block: void*, old_size: size_t, new_size: size_t, alignment: size_t) -> void*
+    ///
+    /// Returns null, leaving the block intact, when there is not enough memory.
+    { A::reallocate(block, size, size, alignment) } -> std::same_as<void*>;
+    /// static fun try_expand_in_place(block: void*, new_size: size_t) -> bool
+    { A::try_expand_in_place(block, size) } -> std::same_as<bool>;
+};
+
+/// Allocates storage from the global heap. The default allocator of flexible arrays.
+struct DefaultAllocator
+{
+    [[nodiscard]] static auto allocate(const size_t size, const size_t alignment) -> void*
+    {
+        return Detail::aligned_alloc(size, alignment);
+    }
+
+    static void deallocate(void* block, size_t /*size*/, size_t /*alignment*/) { Detail::aligned_free(block); }
+
+    [[nodiscard]] static auto reallocate(void* block, const size_t old_size, const size_t new_size,
+                                         const size_t alignment) -> void*
+    {
+        return Detail::aligned_realloc(block, old_size, new_size, alignment);
+    }
+
+    /// Never expands a block in place: the heap offers no supported way to check that a block can grow, as writing past
+    /// the requested size of a block is undefined even if `malloc_usable_size` covers it. `reallocate` leaves growing in
+    /// place to `realloc`.
+    [[nodiscard]] static auto try_expand_in_place(void* /*block*/, size_t /*new_size*/) -> bool { return false; }
+};
+static_assert(ResizingStorageAllocator<DefaultAllocator>);
+
+/// Where the header of a flexible array storage is placed relative to its elements.
+enum class HeaderPlacement
+{
+    /// The header is at the start of the storage, followed by the elements.
+    leading,
+    /// The elements are at the start of the storage, followed by the header.
+    ///
+    /// Avoids the padding between a header and over-aligned elements, but finding the elements takes a header load.
+    trailing,
+    /// The header directly precedes the elements, and the flexible array points to the first element rather than to
+    /// the header, so that the header is at a negative offset.
+    ///
+    /// Takes the same space as `leading`, but element access needs no offset and the pointer can be handed to C APIs.
+    preceding_elements,
+};
+
+/// The layout of a flexible array storage, chosen at compile time.
+struct StorageLayoutDescriptor
+{
+    HeaderPlacement header_placement;
+    size_t header_size;
+    size_t header_alignment;
+    size_t element_size;
+    size_t element_alignment;
+
+    /// The descriptor of a storage of `Header` and `Element`s with the header at `placement`.
+    template <typename Header, typename Element>
+    [[nodiscard]] static consteval auto of(const HeaderPlacement placement) noexcept -> StorageLayoutDescriptor
+    {
+        return {placement, sizeof(Header), alignof(Header), sizeof(Element), alignof(Element)};
+    }
+
+    /// The alignment of the storage, suitable for both the header and the elements.
+    [[nodiscard]] constexpr auto alignment() const noexcept -> size_t
+    {
+        return std::max(header_alignment, element_alignment);
+    }
+
+    /// The offset of the header from the start of a storage for `capacity` elements, given in bytes.
+    [[nodiscard]] constexpr auto header_offset(const Int capacity) const noexcept -> size_t
+    {
+        switch (header_placement)
+        {
+        case HeaderPlacement::leading:
+            return 0;
+        case HeaderPlacement::trailing:
+            return align_up(element_size * static_cast<size_t>(capacity), header_alignment);
+        case HeaderPlacement::preceding_elements:
+            return elements_offset() - header_size;
+        }
+        std::unreachable();
+    }
+
+    /// The offset of the first element from the start of the storage, given in bytes.
+    [[nodiscard]] constexpr auto elements_offset() const noexcept -> size_t
+    {
+        if (header_placement == HeaderPlacement::trailing)
+        {
+            return 0;
+        }
+        return align_up(header_size, element_alignment);
+    }
+
+    /// The offset of the address a flexible array points to from the start of a storage for `capacity` elements,
+    /// given in bytes.
+    ///
+    /// The flexible array points to the first element if the header precedes the elements, or to the header otherwise.
+    [[nodiscard]] constexpr auto pointer_offset(const Int capacity) const noexcept -> size_t
+    {
+        if (header_placement == HeaderPlacement::preceding_elements)
+        {
+            return elements_offset();
+        }
+        return header_offset(capacity);
+    }
+
+    /// The total space required for the storage of `capacity` elements, given in bytes.
+    ///
+    /// Guaranteed to be a multiple of the header's alignment.
+    [[nodiscard]] constexpr auto storage_size(const Int capacity) const noexcept -> size_t
+    {
+        if (header_placement == HeaderPlacement::trailing)
+        {
+            return header_offset(capacity) + header_size;
+        }
+        return align_up(elements_offset() + (element_size * static_cast<size_t>(capacity)), header_alignment);
+    }
+
+    /// The bytes of a storage for `capacity` elements that hold neither the header nor the elements.
+    [[nodiscard]] constexpr auto padding_bytes(const Int capacity) const noexcept -> size_t
+    {
+        return storage_size(capacity) - header_size - (element_size * static_cast<size_t>(capacity));
+    }
+};
+
+/// A compile-time strategy for placing the header of a flexible array storage.
+template <typename L>
+concept StorageLayoutPolicy = requires {
+    /// static consteval fun header_placement<Header, Element>() -> HeaderPlacement
+    { L::template header_placement<Int, Int>() } -> std::same_as<HeaderPlacement>;
+};
+
+/// Always places the header before the elements. The default layout of flexible arrays.
+struct HeaderFirstLayout
+{
+    template <typename Header, typename Element>
+    [[nodiscard]] static consteval auto header_placement() noexcept -> HeaderPlacement
+    {
+        return HeaderPlacement::leading;
+    }
+};
+
+/// Places the header directly before the elements, and points flexible arrays to their first element.
+struct ElementPointerLayout
+{
+    template <typename Header, typename Element>
+    [[nodiscard]] static consteval auto header_placement() noexcept -> HeaderPlacement
+    {
+        return HeaderPlacement::preceding_elements;
+    }
+};
+
+/// Always places the header after the elements.
+struct HeaderLastLayout
+{
+    template <typename Header, typename Element>
+    [[nodiscard]] static consteval auto header_placement() noexcept -> HeaderPlacement
+    {
+        return HeaderPlacement::trailing;
+    }
+};
+
+/// Places the header after the elements when a leading header would need padding before the elements.
+///
+/// That padding only occurs when the elements are aligned stricter than the header, and then the elements leave a
+/// trailing header aligned without any padding, so this layout never takes more space than a header-first one.
+struct CompactLayout
+{
+    template <typename Header, typename Element>
+    [[nodiscard]] static consteval auto header_placement() noexcept -> HeaderPlacement
+    {
+        return align_up(sizeof(Header), alignof(Element)) > sizeof(Header) ? HeaderPlacement::trailing
+                                                                          : HeaderPlacement::leading;
+    }
+};
+static_assert(StorageLayoutPolicy<HeaderFirstLayout> && StorageLayoutPolicy<ElementPointerLayout> &&
+              StorageLayoutPolicy<HeaderLastLayout> && StorageLayoutPolicy<CompactLayout>);
+
 
 //
 // void test_f()
@@ -109,5 +419,37 @@ public:
     }
 
     [[nodiscard]] Int count() const noexcept { return count_; }
+
+    /// The address of the first element.
+    template <typename Self>
+    [[nodiscard]] constexpr auto data(this Self&& self) noexcept -> const_pointee_like<Self, Element*>
+    {
+        return self.start_;
+    }
+
+    /// Contiguous iterators over the elements, which are plain pointers, so that loops over them can be vectorized
+    /// and algorithms such as `std::ranges::copy` can lower to memmove.
+    template <typename Self>
+    [[nodiscard]] constexpr auto begin(this Self&& self) noexcept -> const_pointee_like<Self, Element*>
+    {
+        return self.start_;
+    }
+
+    template <typename Self>
+    [[nodiscard]] constexpr auto end(this Self&& self) noexcept -> const_pointee_like<Self, Element*>
+    {
+        return self.start_ + self.count_;
+    }
+
+    /// Views the elements as a span.
+    [[nodiscard]] constexpr operator std::span<Element>() noexcept // NOLINT(google-explicit-constructor)
+    {
+        return {start_, static_cast<size_t>(count_)};
+    }
+
+    [[nodiscard]] constexpr operator std::span<const Element>() const noexcept // NOLINT(google-explicit-constructor)
+    {
+        return {start_, static_cast<size_t>(count_)};
+    }
 };
 #endif // CPP_MVS_LIBRARY_H
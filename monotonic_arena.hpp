@@ -0,0 +1,213 @@
+#ifndef CPP_MVS_MONOTONIC_ARENA_HPP
+#define CPP_MVS_MONOTONIC_ARENA_HPP
+
+#include "library.h"
+
+/// A bump-pointer allocator whose allocations are all released at once.
+///
+/// Memory is carved out of chunks that double in size as the arena fills up, so that an allocation costs a pointer
+/// bump in the common case. Individual allocations are never freed, except that the most recent one can be grown
+/// in place.
+///
+/// The arena is neither copyable nor movable, as the storage it hands out refers to its chunks.
+class MonotonicArena
+{
+    /// The bookkeeping at the start of every chunk, linking it to the chunk allocated before it.
+    struct Chunk
+    {
+        Chunk* previous;
+        size_t size;
+    };
+
+    /// The offset of the first usable byte from the start of a chunk.
+    static constexpr size_t chunk_payload_offset = align_up(sizeof(Chunk), alignof(std::max_align_t));
+
+    /// The size above which chunks stop doubling.
+    static constexpr size_t maximum_chunk_size = size_t{64} * 1024 * 1024;
+
+    /// The most recently allocated chunk, which `cursor` and `limit` point into. Null if there are no chunks.
+    Chunk* last_chunk = nullptr;
+
+    /// The first free byte of the last chunk.
+    char* cursor = nullptr;
+
+    /// The end of the last chunk.
+    char* limit = nullptr;
+
+    /// The block handed out most recently, which may still be grown in place.
+    char* last_allocation = nullptr;
+
+    /// The size of the next chunk, unless a bigger allocation requires more.
+    size_t next_chunk_size;
+
+    /// The arena used by `ArenaAllocator` on the current thread.
+    static inline thread_local MonotonicArena* installed = nullptr;
+
+    /// Appends a chunk with at least `minimum_payload` usable bytes.
+    void add_chunk(const size_t minimum_payload)
+    {
+        const size_t chunk_size =
+            align_up(std::max(next_chunk_size, chunk_payload_offset + minimum_payload), alignof(std::max_align_t));
+        auto* chunk = static_cast<Chunk*>(Detail::aligned_alloc(chunk_size, alignof(std::max_align_t)));
+        precondition(chunk != nullptr, "Out of memory");
+        chunk->previous = last_chunk;
+        chunk->size = chunk_size;
+
+        last_chunk = chunk;
+        cursor = reinterpret_cast<char*>(chunk) + chunk_payload_offset;
+        limit = reinterpret_cast<char*>(chunk) + chunk_size;
+        next_chunk_size = std::min(next_chunk_size * 2, maximum_chunk_size);
+    }
+
+    /// Frees the chunks allocated before `last_chunk`.
+    void free_previous_chunks() noexcept
+    {
+        Chunk* chunk = last_chunk != nullptr ? std::exchange(last_chunk->previous, nullptr) : nullptr;
+        while (chunk != nullptr)
+        {
+            Detail::aligned_free(std::exchange(chunk, chunk->previous));
+        }
+    }
+
+public:
+    /// The size of the first chunk of an arena, unless specified otherwise.
+    static constexpr size_t default_initial_chunk_size = size_t{64} * 1024;
+
+    /// Creates an arena without allocating. The first allocation allocates a chunk of `initial_chunk_size` bytes.
+    [[nodiscard]] explicit MonotonicArena(const size_t initial_chunk_size = default_initial_chunk_size) noexcept :
+        next_chunk_size(std::max(initial_chunk_size, chunk_payload_offset))
+    {
+    }
+
+    /// Allocates `size` bytes aligned to `alignment`, which must be a power of two.
+    [[nodiscard]] auto allocate(const size_t size, const size_t alignment) -> void*
+    {
+        auto address = align_up(reinterpret_cast<uintptr_t>(cursor), static_cast<uintptr_t>(alignment));
+        if (cursor == nullptr || address + size > reinterpret_cast<uintptr_t>(limit))
+        {
+            add_chunk(size + alignment);
+            address = align_up(reinterpret_cast<uintptr_t>(cursor), static_cast<uintptr_t>(alignment));
+        }
+        last_allocation = reinterpret_cast<char*>(address);
+        cursor = last_allocation + size;
+        return last_allocation;
+    }
+
+    /// Tries to grow or shrink `block` to `new_size` bytes without moving it.
+    ///
+    /// Only the most recent allocation can be resized, and only within the current chunk.
+    [[nodiscard]] auto try_resize_in_place(void* block, const size_t new_size) noexcept -> bool
+    {
+        if (block == nullptr || block != last_allocation ||
+            new_size > static_cast<size_t>(limit - last_allocation))
+        {
+            return false;
+        }
+        cursor = last_allocation + new_size;
+        return true;
+    }
+
+    /// Releases every allocation at once, keeping the most recent chunk for reuse.
+    ///
+    /// Storage handed out before the reset must no longer be used.
+    void reset() noexcept
+    {
+        free_previous_chunks();
+        if (last_chunk != nullptr)
+        {
+            cursor = reinterpret_cast<char*>(last_chunk) + chunk_payload_offset;
+        }
+        last_allocation = nullptr;
+    }
+
+    /// Releases every allocation at once and returns all chunks to the heap.
+    ///
+    /// Storage handed out before the release must no longer be used.
+    void release() noexcept
+    {
+        free_previous_chunks();
+        if (last_chunk != nullptr)
+        {
+            Detail::aligned_free(std::exchange(last_chunk, nullptr));
+        }
+        cursor = nullptr;
+        limit = nullptr;
+        last_allocation = nullptr;
+    }
+
+    /// The total size of the chunks currently owned by the arena, given in bytes.
+    [[nodiscard]] auto reserved_bytes() const noexcept -> size_t
+    {
+        size_t total = 0;
+        for (const Chunk* chunk = last_chunk; chunk != nullptr; chunk = chunk->previous)
+        {
+            total += chunk->size;
+        }
+        return total;
+    }
+
+    /// The arena that `ArenaAllocator` allocates from on the current thread, or null if there is none.
+    [[nodiscard]] static auto installed_on_current_thread() noexcept -> MonotonicArena* { return installed; }
+
+    /// Installs an arena for `ArenaAllocator` on the current thread for the lifetime of the scope object.
+    ///
+    /// Scopes nest: the previously installed arena is restored when the scope ends.
+    class Scope
+    {
+        MonotonicArena* previous;
+
+    public:
+        [[nodiscard]] explicit Scope(MonotonicArena& arena) noexcept : previous(std::exchange(installed, &arena)) {}
+        ~Scope() { installed = previous; }
+
+        Scope(const Scope& other) = delete;
+        Scope& operator=(const Scope& other) = delete;
+        Scope(Scope&& other) = delete;
+        Scope& operator=(Scope&& other) = delete;
+    };
+
+    MonotonicArena(const MonotonicArena& other) = delete;
+    MonotonicArena& operator=(const MonotonicArena& other) = delete;
+    MonotonicArena(MonotonicArena&& other) = delete;
+    MonotonicArena& operator=(MonotonicArena&& other) = delete;
+
+    /// Returns all chunks to the heap.
+    ~MonotonicArena() { release(); }
+};
+
+/// A StorageAllocator carving storage out of the MonotonicArena installed on the current thread.
+///
+/// Deallocation is a no-op: the storage is released in bulk with the arena. A `MonotonicArena::Scope` must be
+/// active whenever a flexible array using this allocator allocates or grows.
+struct ArenaAllocator
+{
+    [[nodiscard]] static auto allocate(const size_t size, const size_t alignment) -> void*
+    {
+        MonotonicArena* arena = MonotonicArena::installed_on_current_thread();
+        precondition(arena != nullptr, "No MonotonicArena is installed on the current thread");
+        return arena->allocate(size, alignment);
+    }
+
+    static void deallocate(void* /*block*/, size_t /*size*/, size_t /*alignment*/) {}
+
+    [[nodiscard]] static auto reallocate(void* block, const size_t old_size, const size_t new_size,
+                                         const size_t alignment) -> void*
+    {
+        if (try_expand_in_place(block, new_size))
+        {
+            return block;
+        }
+        void* new_block = allocate(new_size, alignment);
+        std::memcpy(new_block, block, std::min(old_size, new_size));
+        return new_block;
+    }
+
+    [[nodiscard]] static auto try_expand_in_place(void* block, const size_t new_size) -> bool
+    {
+        MonotonicArena* arena = MonotonicArena::installed_on_current_thread();
+        return arena != nullptr && arena->try_resize_in_place(block, new_size);
+    }
+};
+static_assert(ResizingStorageAllocator<ArenaAllocator>);
+
+#endif // CPP_MVS_MONOTONIC_ARENA_HPP
@@ -0,0 +1,157 @@
+#include "perf_counters.hpp"
+
+#include <tuple>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr std::array<const char*, perf_event_count> event_names = {
+        "cycles", "instructions", "L1d_misses", "LLC_misses", "dTLB_misses", "branch_misses",
+    };
+
+#if defined(__linux__)
+    /// The perf_event_attr type and config of `event`.
+    [[nodiscard]] auto event_type_and_config(const PerfEvent event) noexcept -> std::pair<uint32_t, uint64_t>
+    {
+        constexpr auto cache_event = [](const uint64_t cache) -> uint64_t
+        {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        switch (event)
+        {
+            case PerfEvent::cycles:
+                return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+            case PerfEvent::instructions:
+                return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+            case PerfEvent::l1d_read_misses:
+                return {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D)};
+            case PerfEvent::llc_misses:
+                return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+            case PerfEvent::dtlb_read_misses:
+                return {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB)};
+            case PerfEvent::branch_misses:
+                return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+        }
+        return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+    }
+
+    /// Opens a stopped counter of `event` for the calling thread on any CPU, returning -1 on failure.
+    [[nodiscard]] auto open_event(const PerfEvent event) noexcept -> int
+    {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        std::tie(attributes.type, attributes.config) = event_type_and_config(event);
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+#endif
+} // namespace
+
+auto perf_event_name(const PerfEvent event) noexcept -> const char*
+{
+    return event_names[static_cast<size_t>(event)];
+}
+
+PerfCounters::PerfCounters() noexcept
+{
+    descriptors.fill(-1);
+#if defined(__linux__)
+    for (Int i = 0; i < perf_event_count; ++i)
+    {
+        descriptors[i] = open_event(static_cast<PerfEvent>(i));
+    }
+#endif
+}
+
+auto PerfCounters::is_available(const PerfEvent event) const noexcept -> bool
+{
+    return descriptors[static_cast<size_t>(event)] >= 0;
+}
+
+auto PerfCounters::is_any_available() const noexcept -> bool
+{
+    for (const int descriptor : descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::start() noexcept
+{
+#if defined(__linux__)
+    for (const int descriptor : descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void PerfCounters::stop() noexcept
+{
+#if defined(__linux__)
+    for (const int descriptor : descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (Int i = 0; i < perf_event_count; ++i)
+    {
+        struct
+        {
+            uint64_t value;
+            uint64_t time_enabled;
+            uint64_t time_running;
+        } reading{};
+        if (descriptors[i] < 0 || read(descriptors[i], &reading, sizeof(reading)) != sizeof(reading) ||
+            reading.time_running == 0)
+        {
+            continue;
+        }
+        // Extrapolates over the time the event was scheduled out for multiplexing.
+        totals[i] += static_cast<double>(reading.value) * static_cast<double>(reading.time_enabled) /
+                     static_cast<double>(reading.time_running);
+    }
+#endif
+}
+
+auto PerfCounters::total(const PerfEvent event) const noexcept -> std::optional<double>
+{
+    if (!is_available(event))
+    {
+        return std::nullopt;
+    }
+    return totals[static_cast<size_t>(event)];
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+    for (const int descriptor : descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            close(descriptor);
+        }
+    }
+#endif
+}
@@ -0,0 +1,70 @@
+#ifndef CPP_MVS_PERF_COUNTERS_HPP
+#define CPP_MVS_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include "library.h"
+
+/// A hardware event counted by PerfCounters.
+enum class PerfEvent
+{
+    cycles,
+    instructions,
+    l1d_read_misses,
+    llc_misses,
+    dtlb_read_misses,
+    branch_misses,
+};
+
+/// The number of PerfEvent values.
+inline constexpr Int perf_event_count = 6;
+
+/// A short name of `event`, suitable as a column name in reports.
+[[nodiscard]] auto perf_event_name(PerfEvent event) noexcept -> const char*;
+
+/// Hardware performance counters of the calling thread, read through Linux `perf_event_open`.
+///
+/// Every event is opened separately, so that the ones the kernel or the hardware doesn't support are simply missing
+/// instead of failing the others. Inside containers, or with a restrictive `perf_event_paranoid`, none may be
+/// available; measurements then report no counts rather than failing. On other systems no counter is ever available.
+///
+/// Counts only user-space events, scaled up when the kernel multiplexes more events than the hardware can count
+/// at once.
+class PerfCounters
+{
+    /// The file descriptors of the opened events, -1 if the event is unavailable.
+    std::array<int, perf_event_count> descriptors;
+
+    /// The counts accumulated over the finished measurements.
+    std::array<double, perf_event_count> totals{};
+
+public:
+    /// Opens the counters of the calling thread, stopped.
+    [[nodiscard]] PerfCounters() noexcept;
+
+    /// Whether `event` is counted.
+    [[nodiscard]] auto is_available(PerfEvent event) const noexcept -> bool;
+
+    /// Whether any event is counted.
+    [[nodiscard]] auto is_any_available() const noexcept -> bool;
+
+    /// Starts counting from zero, discarding the counts of the previous measurement.
+    void start() noexcept;
+
+    /// Stops counting, adding the counts since the last `start` to the totals.
+    void stop() noexcept;
+
+    /// The total count of `event` over all measurements, or nothing if the event is unavailable.
+    [[nodiscard]] auto total(PerfEvent event) const noexcept -> std::optional<double>;
+
+    PerfCounters(const PerfCounters& other) = delete;
+    PerfCounters& operator=(const PerfCounters& other) = delete;
+    PerfCounters(PerfCounters&& other) = delete;
+    PerfCounters& operator=(PerfCounters&& other) = delete;
+
+    /// Closes the counters.
+    ~PerfCounters();
+};
+
+#endif // CPP_MVS_PERF_COUNTERS_HPP
@@ -0,0 +1,264 @@
+#ifndef CPP_MVS_POOL_ALLOCATOR_HPP
+#define CPP_MVS_POOL_ALLOCATOR_HPP
+
+#include <array>
+#include <bit>
+#include <mutex>
+#include "library.h"
+
+/// A StorageAllocator serving small storage from per-size-class free lists, avoiding malloc on the hot path.
+///
+/// Requests are rounded up to power-of-two size classes, whose blocks are also aligned to their size. Every thread
+/// caches free blocks of each class, so allocating and deallocating is a thread-local list push or pop. Blocks move
+/// between the thread caches and a central list per class in batches, which is the only time a lock is taken.
+/// Memory is carved from slabs that are kept for the lifetime of the program.
+///
+/// Requests bigger than `largest_class_size` are forwarded to the DefaultAllocator.
+class PoolAllocator
+{
+    /// A block on a free list. The first block of a batch also links the batches and knows the batch size.
+    struct FreeBlock
+    {
+        FreeBlock* next;
+        FreeBlock* next_batch;
+        Int batch_count;
+    };
+
+    static constexpr size_t smallest_class_size = 32;
+    static_assert(sizeof(FreeBlock) <= smallest_class_size);
+
+    /// The number of size classes, doubling from `smallest_class_size`.
+    static constexpr Int class_count = 9;
+
+    /// The number of batches carved from a slab at once.
+    static constexpr Int batches_per_slab = 4;
+
+    /// The free blocks of a size class shared by all threads, as a list of batches.
+    struct CentralList
+    {
+        std::mutex mutex;
+        FreeBlock* batches = nullptr;
+
+        void push_batch(FreeBlock* batch)
+        {
+            const std::scoped_lock lock{mutex};
+            batch->next_batch = batches;
+            batches = batch;
+        }
+
+        [[nodiscard]] auto pop_batch() -> FreeBlock*
+        {
+            const std::scoped_lock lock{mutex};
+            FreeBlock* batch = batches;
+            if (batch != nullptr)
+            {
+                batches = batch->next_batch;
+            }
+            return batch;
+        }
+    };
+
+    /// The free blocks of each size class owned by a single thread.
+    struct ThreadCache
+    {
+        std::array<FreeBlock*, class_count> heads{};
+        std::array<Int, class_count> counts{};
+
+        /// Hands the cached blocks back to the central lists, so that other threads can reuse them.
+        ///
+        /// Marks the cache destroyed, so that thread-local objects destroyed after it use the central lists directly.
+        ~ThreadCache()
+        {
+            for (Int size_class = 0; size_class < class_count; ++size_class)
+            {
+                while (heads[size_class] != nullptr)
+                {
+                    flush_batch(*this, size_class);
+                }
+            }
+            thread_cache_destroyed() = true;
+        }
+    };
+
+    /// The central lists, which are never destroyed so that exiting threads can always flush into them.
+    [[nodiscard]] static auto central_list(const Int size_class) -> CentralList&
+    {
+        static auto* const lists = new std::array<CentralList, class_count>();
+        return (*lists)[size_class];
+    }
+
+    /// Requires the cache of the current thread not to be destroyed yet.
+    [[nodiscard]] static auto thread_cache() -> ThreadCache&
+    {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    /// Whether the cache of the current thread was destroyed at thread exit.
+    ///
+    /// Thread-local objects constructed before the first use of the pool on a thread are destroyed after its cache, and
+    /// may still free storage. The flag is trivially destructible, so it stays readable until the thread ends.
+    [[nodiscard]] static auto thread_cache_destroyed() noexcept -> bool&
+    {
+        thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    /// The number of blocks moved between a thread cache and the central list at once.
+    [[nodiscard]] static constexpr auto batch_size(const Int size_class) noexcept -> Int
+    {
+        return std::clamp(static_cast<Int>(size_t{16} * 1024 / class_size(size_class)), Int{8}, Int{64});
+    }
+
+    /// Moves up to a batch of blocks from the thread cache to the central list.
+    ///
+    /// Requires the thread cache to hold at least one block of the class.
+    static void flush_batch(ThreadCache& cache, const Int size_class)
+    {
+        FreeBlock* const first = cache.heads[size_class];
+        FreeBlock* last = first;
+        Int count = 1;
+        while (count < batch_size(size_class) && last->next != nullptr)
+        {
+            last = last->next;
+            ++count;
+        }
+        cache.heads[size_class] = last->next;
+        cache.counts[size_class] -= count;
+
+        last->next = nullptr;
+        first->batch_count = count;
+        central_list(size_class).push_batch(first);
+    }
+
+    /// Allocates a slab and splits it into batches, returning one and handing the rest to the central list.
+    [[nodiscard]] static auto carve_slab(const Int size_class) -> FreeBlock*
+    {
+        const size_t block_size = class_size(size_class);
+        const Int blocks_per_batch = batch_size(size_class);
+        auto* const slab = static_cast<char*>(
+            Detail::aligned_alloc(block_size * static_cast<size_t>(blocks_per_batch * batches_per_slab), block_size));
+        precondition(slab != nullptr, "Out of memory");
+
+        FreeBlock* first_batch = nullptr;
+        for (Int batch_index = 0; batch_index < batches_per_slab; ++batch_index)
+        {
+            char* const batch_start = slab + (block_size * static_cast<size_t>(batch_index * blocks_per_batch));
+            FreeBlock* next = nullptr;
+            for (Int i = blocks_per_batch - 1; i >= 0; --i)
+            {
+                next = ::new (batch_start + (block_size * static_cast<size_t>(i))) FreeBlock{next, nullptr, 0};
+            }
+            next->batch_count = blocks_per_batch;
+
+            if (first_batch == nullptr)
+            {
+                first_batch = next;
+            }
+            else
+            {
+                central_list(size_class).push_batch(next);
+            }
+        }
+        return first_batch;
+    }
+
+    /// Fills the empty thread cache of the class with a batch from the central list or from a fresh slab.
+    static void refill(ThreadCache& cache, const Int size_class)
+    {
+        FreeBlock* batch = central_list(size_class).pop_batch();
+        if (batch == nullptr)
+        {
+            batch = carve_slab(size_class);
+        }
+        cache.heads[size_class] = batch;
+        cache.counts[size_class] = batch->batch_count;
+    }
+
+    /// Takes a single block of the class from the central list, for a thread whose cache was destroyed.
+    [[nodiscard]] static auto allocate_uncached(const Int size_class) -> FreeBlock*
+    {
+        FreeBlock* batch = central_list(size_class).pop_batch();
+        if (batch == nullptr)
+        {
+            batch = carve_slab(size_class);
+        }
+        if (FreeBlock* const rest = batch->next; rest != nullptr)
+        {
+            rest->batch_count = batch->batch_count - 1;
+            central_list(size_class).push_batch(rest);
+        }
+        return batch;
+    }
+
+public:
+    /// The biggest request served from the pool, given in bytes.
+    static constexpr size_t largest_class_size = smallest_class_size << (class_count - 1);
+
+    /// The size class serving blocks of `size` bytes aligned to `alignment`, or -1 if the request is too big.
+    [[nodiscard]] static constexpr auto size_class_for(const size_t size, const size_t alignment) noexcept -> Int
+    {
+        const size_t block_size = std::bit_ceil(std::max({size, alignment, smallest_class_size}));
+        if (block_size > largest_class_size)
+        {
+            return -1;
+        }
+        return std::countr_zero(block_size) - std::countr_zero(smallest_class_size);
+    }
+
+    /// The size of the blocks of `size_class`, given in bytes. Blocks are aligned to their size.
+    [[nodiscard]] static constexpr auto class_size(const Int size_class) noexcept -> size_t
+    {
+        return smallest_class_size << size_class;
+    }
+
+    [[nodiscard]] static auto allocate(const size_t size, const size_t alignment) -> void*
+    {
+        const Int size_class = size_class_for(size, alignment);
+        if (size_class < 0)
+        {
+            return DefaultAllocator::allocate(size, alignment);
+        }
+        if (thread_cache_destroyed()) [[unlikely]]
+        {
+            return allocate_uncached(size_class);
+        }
+
+        ThreadCache& cache = thread_cache();
+        if (cache.heads[size_class] == nullptr)
+        {
+            refill(cache, size_class);
+        }
+        FreeBlock* const block = cache.heads[size_class];
+        cache.heads[size_class] = block->next;
+        --cache.counts[size_class];
+        return block;
+    }
+
+    static void deallocate(void* block, const size_t size, const size_t alignment)
+    {
+        const Int size_class = size_class_for(size, alignment);
+        if (size_class < 0)
+        {
+            DefaultAllocator::deallocate(block, size, alignment);
+            return;
+        }
+        if (thread_cache_destroyed()) [[unlikely]]
+        {
+            // Handed back as a batch of its own, as there is no cache left to collect a batch in.
+            central_list(size_class).push_batch(::new (block) FreeBlock{nullptr, nullptr, 1});
+            return;
+        }
+
+        ThreadCache& cache = thread_cache();
+        cache.heads[size_class] = ::new (block) FreeBlock{cache.heads[size_class], nullptr, 0};
+        // Keeping up to two batches lets alternating allocations and deallocations stay thread-local.
+        if (++cache.counts[size_class] > 2 * batch_size(size_class))
+        {
+            flush_batch(cache, size_class);
+        }
+    }
+};
+static_assert(StorageAllocator<PoolAllocator>);
+
+#endif // CPP_MVS_POOL_ALLOCATOR_HPP
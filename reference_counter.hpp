@@ -0,0 +1,110 @@
+#ifndef CPP_MVS_REFERENCE_COUNTER_HPP
+#define CPP_MVS_REFERENCE_COUNTER_HPP
+
+#include <atomic>
+#include "library.h"
+
+/// A count of the references to a shared storage, kept in the storage's header.
+///
+/// Counters start out with a single reference. They are trivially copyable, so that headers containing them can be
+/// relocated bytewise together with the rest of the storage.
+template <typename T>
+concept ReferenceCounter = std::default_initializable<T> && std::is_trivially_copyable_v<T> && requires(T& counter) {
+    /// fun retain()
+    { counter.retain() } -> std::same_as<void>;
+    /// fun release() -> bool
+    ///
+    /// Drops a reference, returning whether it was the last one.
+    { counter.release() } -> std::same_as<bool>;
+    /// fun is_unique() -> bool
+    { std::as_const(counter).is_unique() } -> std::same_as<bool>;
+};
+
+/// Counts references with plain arithmetic. The storage must only be shared by arrays on a single thread.
+class NonAtomicReferenceCounter
+{
+    Int count = 1;
+
+public:
+    void retain() noexcept { ++count; }
+
+    [[nodiscard]] auto release() noexcept -> bool { return --count == 0; }
+
+    [[nodiscard]] auto is_unique() const noexcept -> bool { return count == 1; }
+};
+static_assert(ReferenceCounter<NonAtomicReferenceCounter>);
+
+/// Counts references with atomic read-modify-write operations, so that the storage can be shared across threads.
+class AtomicReferenceCounter
+{
+    alignas(std::atomic_ref<Int>::required_alignment) mutable Int count = 1;
+
+public:
+    void retain() noexcept { std::atomic_ref{count}.fetch_add(1, std::memory_order_relaxed); }
+
+    [[nodiscard]] auto release() noexcept -> bool
+    {
+        // Acquiring makes the last release observe the uses of the other references before it destroys the storage.
+        return std::atomic_ref{count}.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    [[nodiscard]] auto is_unique() const noexcept -> bool
+    {
+        return std::atomic_ref{count}.load(std::memory_order_acquire) == 1;
+    }
+};
+static_assert(ReferenceCounter<AtomicReferenceCounter>);
+
+namespace Detail
+{
+    /// A cheap identifier of the current thread, unique among the running threads.
+    inline auto current_thread_token() noexcept -> uintptr_t
+    {
+        thread_local const char token = 0;
+        return reinterpret_cast<uintptr_t>(&token);
+    }
+} // namespace Detail
+
+/// Counts references with plain stores when they are retained on the thread that created the storage.
+///
+/// Retained references are counted in two halves: `owner_count` counts the ones retained by the owning thread, which
+/// is the only one writing it, so that retaining there costs no atomic read-modify-write. `shared_count` counts the
+/// ones retained by other threads, and every release on any thread decrements it atomically, so it may go negative.
+/// A reference is always retained before the one it was copied from is released, so the acquiring decrement that
+/// brings the sum to zero observes every increment of `owner_count`, and only one release can see a zero sum.
+class BiasedReferenceCounter
+{
+    alignas(std::atomic_ref<Int>::required_alignment) mutable Int owner_count = 1;
+    alignas(std::atomic_ref<Int>::required_alignment) mutable Int shared_count = 0;
+    uintptr_t owner = Detail::current_thread_token();
+
+public:
+    void retain() noexcept
+    {
+        if (owner == Detail::current_thread_token())
+        {
+            // Other threads only read `owner_count`, so a relaxed load and store suffice.
+            std::atomic_ref owned{owner_count};
+            owned.store(owned.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        else
+        {
+            std::atomic_ref{shared_count}.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] auto release() noexcept -> bool
+    {
+        const Int shared_remaining = std::atomic_ref{shared_count}.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        return shared_remaining + std::atomic_ref{owner_count}.load(std::memory_order_relaxed) == 0;
+    }
+
+    [[nodiscard]] auto is_unique() const noexcept -> bool
+    {
+        const Int shared = std::atomic_ref{shared_count}.load(std::memory_order_acquire);
+        return shared + std::atomic_ref{owner_count}.load(std::memory_order_relaxed) == 1;
+    }
+};
+static_assert(ReferenceCounter<BiasedReferenceCounter>);
+
+#endif // CPP_MVS_REFERENCE_COUNTER_HPP
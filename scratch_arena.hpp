@@ -0,0 +1,168 @@
+#ifndef CPP_MVS_SCRATCH_ARENA_HPP
+#define CPP_MVS_SCRATCH_ARENA_HPP
+
+#include "library.h"
+
+/// A per-thread region for short-lived temporaries, allocated and released in LIFO order.
+///
+/// `mark()` remembers the current top of the region and `release()` pops everything allocated since then, so that a
+/// temporary costs a pointer bump, and the memory is reused by the next temporary. Chunks are kept after a release,
+/// so that a thread in a steady state never calls malloc. Unlike alloca, the storage does not live on the call stack,
+/// so it can be big and can be used from deep recursion or coroutine frames.
+///
+/// The arena is neither copyable nor movable, as the storage it hands out refers to its chunks.
+class ScratchArena
+{
+    /// The bookkeeping at the start of every chunk. Chunks form a list in the order they are used.
+    struct Chunk
+    {
+        Chunk* next;
+        size_t size;
+    };
+
+    /// The offset of the first usable byte from the start of a chunk.
+    static constexpr size_t chunk_payload_offset = align_up(sizeof(Chunk), alignof(std::max_align_t));
+
+    /// The size of the first chunk. Later chunks are twice as big as the one before.
+    static constexpr size_t initial_chunk_size = size_t{64} * 1024;
+
+    /// The first chunk, null until the first allocation.
+    Chunk* first_chunk = nullptr;
+
+    /// The chunk `cursor` points into, or null before the first allocation.
+    Chunk* current_chunk = nullptr;
+
+    /// The first free byte of the current chunk.
+    char* cursor = nullptr;
+
+    [[nodiscard]] static auto payload_of(Chunk* chunk) noexcept -> char*
+    {
+        return reinterpret_cast<char*>(chunk) + chunk_payload_offset;
+    }
+
+    [[nodiscard]] static auto end_of(Chunk* chunk) noexcept -> char*
+    {
+        return reinterpret_cast<char*>(chunk) + chunk->size;
+    }
+
+    /// Whether `chunk` has room for `size` bytes aligned to `alignment` at its start.
+    [[nodiscard]] static auto fits(Chunk* chunk, const size_t size, const size_t alignment) noexcept -> bool
+    {
+        return chunk_payload_offset + size + alignment <= chunk->size;
+    }
+
+    /// Makes the chunk after the current one (or the first one) current, allocating it unless a chunk with room for
+    /// `size` bytes aligned to `alignment` is kept from earlier use.
+    void advance_chunk(const size_t size, const size_t alignment)
+    {
+        Chunk** link = current_chunk != nullptr ? &current_chunk->next : &first_chunk;
+        if (*link == nullptr || !fits(*link, size, alignment))
+        {
+            const size_t previous_size = current_chunk != nullptr ? current_chunk->size : initial_chunk_size / 2;
+            const size_t chunk_size =
+                align_up(std::max(previous_size * 2, chunk_payload_offset + size + alignment), alignof(std::max_align_t));
+            auto* chunk = static_cast<Chunk*>(Detail::aligned_alloc(chunk_size, alignof(std::max_align_t)));
+            precondition(chunk != nullptr, "Out of memory");
+            // A kept chunk too small for the request is skipped, and reused after the new one.
+            chunk->next = *link;
+            chunk->size = chunk_size;
+            *link = chunk;
+        }
+        current_chunk = *link;
+        cursor = payload_of(current_chunk);
+    }
+
+public:
+    /// The top of the arena at some point, to release the allocations made after it.
+    struct Marker
+    {
+        Chunk* chunk;
+        char* cursor;
+    };
+
+    [[nodiscard]] ScratchArena() noexcept = default;
+
+    /// The arena of the current thread.
+    [[nodiscard]] static auto for_current_thread() noexcept -> ScratchArena&
+    {
+        thread_local ScratchArena arena;
+        return arena;
+    }
+
+    /// Allocates `size` bytes aligned to `alignment`, which must be a power of two.
+    [[nodiscard]] auto allocate(const size_t size, const size_t alignment) -> void*
+    {
+        auto address = align_up(reinterpret_cast<uintptr_t>(cursor), static_cast<uintptr_t>(alignment));
+        if (current_chunk == nullptr || address + size > reinterpret_cast<uintptr_t>(end_of(current_chunk)))
+        {
+            advance_chunk(size, alignment);
+            address = align_up(reinterpret_cast<uintptr_t>(cursor), static_cast<uintptr_t>(alignment));
+        }
+        cursor = reinterpret_cast<char*>(address + size);
+        return reinterpret_cast<void*>(address);
+    }
+
+    /// Remembers the current top of the arena.
+    [[nodiscard]] auto mark() const noexcept -> Marker { return {current_chunk, cursor}; }
+
+    /// Releases every allocation made since `marker` was taken, keeping the chunks for reuse.
+    ///
+    /// Markers must be released in the reverse order they were taken.
+    void release(const Marker marker) noexcept
+    {
+        current_chunk = marker.chunk;
+        cursor = marker.cursor;
+    }
+
+    /// The total size of the chunks owned by the arena, given in bytes.
+    [[nodiscard]] auto reserved_bytes() const noexcept -> size_t
+    {
+        size_t total = 0;
+        for (const Chunk* chunk = first_chunk; chunk != nullptr; chunk = chunk->next)
+        {
+            total += chunk->size;
+        }
+        return total;
+    }
+
+    /// Frees the chunks after the current one, which are only kept for reuse.
+    void trim() noexcept
+    {
+        Chunk** link = current_chunk != nullptr ? &current_chunk->next : &first_chunk;
+        Chunk* chunk = std::exchange(*link, nullptr);
+        while (chunk != nullptr)
+        {
+            Detail::aligned_free(std::exchange(chunk, chunk->next));
+        }
+    }
+
+    /// Takes a marker on construction and releases it on destruction.
+    class Scope
+    {
+        ScratchArena& arena;
+        Marker marker;
+
+    public:
+        [[nodiscard]] explicit Scope(ScratchArena& arena) noexcept : arena(arena), marker(arena.mark()) {}
+        ~Scope() { arena.release(marker); }
+
+        Scope(const Scope& other) = delete;
+        Scope& operator=(const Scope& other) = delete;
+        Scope(Scope&& other) = delete;
+        Scope& operator=(Scope&& other) = delete;
+    };
+
+    ScratchArena(const ScratchArena& other) = delete;
+    ScratchArena& operator=(const ScratchArena& other) = delete;
+    ScratchArena(ScratchArena&& other) = delete;
+    ScratchArena& operator=(ScratchArena&& other) = delete;
+
+    /// Returns all chunks to the heap.
+    ~ScratchArena()
+    {
+        current_chunk = nullptr;
+        trim();
+    }
+};
+
+#endif // CPP_MVS_SCRATCH_ARENA_HPP
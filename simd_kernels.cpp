@@ -0,0 +1,172 @@
+#include "simd_kernels.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    using SimdKernels::Lane;
+
+    template <size_t size>
+    [[nodiscard]] auto load_lane(const std::byte* const address) noexcept -> Lane<size>
+    {
+        Lane<size> lane;
+        std::memcpy(&lane, address, size);
+        return lane;
+    }
+
+    template <size_t size>
+    void fill(std::byte* const destination, const Int count, const uint64_t value) noexcept
+    {
+        const auto lane = static_cast<Lane<size>>(value);
+        for (Int i = 0; i < count; ++i)
+        {
+            std::memcpy(destination + (i * size), &lane, size);
+        }
+    }
+
+    auto equal(const std::byte* const a, const std::byte* const b, const size_t size) noexcept -> bool
+    {
+        return std::memcmp(a, b, size) == 0;
+    }
+
+    template <size_t size>
+    auto find(const std::byte* const elements, const Int count, const uint64_t value) noexcept -> Int
+    {
+        const auto lane = static_cast<Lane<size>>(value);
+        for (Int i = 0; i < count; ++i)
+        {
+            if (load_lane<size>(elements + (i * size)) == lane)
+            {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    template <size_t size>
+    auto count(const std::byte* const elements, const Int count, const uint64_t value) noexcept -> Int
+    {
+        const auto lane = static_cast<Lane<size>>(value);
+        Int matches = 0;
+        for (Int i = 0; i < count; ++i)
+        {
+            matches += load_lane<size>(elements + (i * size)) == lane ? 1 : 0;
+        }
+        return matches;
+    }
+
+    template <typename Integer>
+    void min_max(const std::byte* const elements, const Int count, std::byte* const minimum,
+                 std::byte* const maximum) noexcept
+    {
+        Integer low = load_lane<sizeof(Integer)>(elements);
+        Integer high = low;
+        for (Int i = 1; i < count; ++i)
+        {
+            const auto element = static_cast<Integer>(load_lane<sizeof(Integer)>(elements + (i * sizeof(Integer))));
+            low = std::min(low, element);
+            high = std::max(high, element);
+        }
+        std::memcpy(minimum, &low, sizeof(Integer));
+        std::memcpy(maximum, &high, sizeof(Integer));
+    }
+
+    [[nodiscard]] auto select_kernels() noexcept -> const SimdKernels::KernelTable&
+    {
+        using namespace SimdKernels;
+        InstructionSet instruction_set = best_supported();
+        if (const char* const forced = std::getenv(force_instruction_set_variable))
+        {
+            const auto named = instruction_set_named(forced);
+            precondition(named.has_value() && is_supported(*named),
+                         "CPP_MVS_FORCE_ISA names an instruction set unknown to this build or unsupported by the CPU");
+            instruction_set = *named;
+        }
+        return *kernels_for(instruction_set);
+    }
+} // namespace
+
+constinit const SimdKernels::KernelTable SimdKernels::scalar_kernels = {
+    .name = "scalar",
+    .fill = {fill<1>, fill<2>, fill<4>, fill<8>},
+    .equal = equal,
+    .find = {find<1>, find<2>, find<4>, find<8>},
+    .count = {count<1>, count<2>, count<4>, count<8>},
+    .min_max_i32 = min_max<int32_t>,
+    .min_max_i64 = min_max<int64_t>,
+};
+
+auto SimdKernels::kernels_for(const InstructionSet instruction_set) noexcept -> const KernelTable*
+{
+    switch (instruction_set)
+    {
+    case InstructionSet::scalar:
+        return &scalar_kernels;
+#ifdef CPP_MVS_X86_KERNELS
+    case InstructionSet::sse42:
+        return &sse42_kernels;
+    case InstructionSet::avx2:
+        return &avx2_kernels;
+    case InstructionSet::avx512:
+        return &avx512_kernels;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+auto SimdKernels::is_supported(const InstructionSet instruction_set) noexcept -> bool
+{
+    if (kernels_for(instruction_set) == nullptr)
+    {
+        return false;
+    }
+#ifdef CPP_MVS_X86_KERNELS
+    __builtin_cpu_init();
+    switch (instruction_set)
+    {
+    case InstructionSet::scalar:
+        return true;
+    case InstructionSet::sse42:
+        return __builtin_cpu_supports("sse4.2");
+    case InstructionSet::avx2:
+        return __builtin_cpu_supports("avx2");
+    case InstructionSet::avx512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+#endif
+    return instruction_set == InstructionSet::scalar;
+}
+
+auto SimdKernels::best_supported() noexcept -> InstructionSet
+{
+    for (auto it = all_instruction_sets.rbegin(); it != all_instruction_sets.rend(); ++it)
+    {
+        if (is_supported(*it))
+        {
+            return *it;
+        }
+    }
+    return InstructionSet::scalar;
+}
+
+auto SimdKernels::instruction_set_named(const std::string_view name) noexcept -> std::optional<InstructionSet>
+{
+    for (const InstructionSet instruction_set : all_instruction_sets)
+    {
+        const KernelTable* const kernels = kernels_for(instruction_set);
+        if (kernels != nullptr && name == kernels->name)
+        {
+            return instruction_set;
+        }
+    }
+    return std::nullopt;
+}
+
+auto SimdKernels::active() noexcept -> const KernelTable&
+{
+    static const KernelTable& kernels = select_kernels();
+    return kernels;
+}
@@ -0,0 +1,117 @@
+#ifndef CPP_MVS_SIMD_KERNELS_HPP
+#define CPP_MVS_SIMD_KERNELS_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include "library.h"
+
+/// Vectorized kernels behind the bulk algorithms, working on the bytes of trivially copyable elements.
+///
+/// Every kernel is implemented for several instruction sets, and the best one the running CPU supports is picked at
+/// runtime, so that a binary built for baseline x86-64 still uses AVX2 or AVX-512 where available. The environment
+/// variable `CPP_MVS_FORCE_ISA` overrides the choice, e.g. `CPP_MVS_FORCE_ISA=sse4.2 ./benchmarks`, so that every
+/// implementation can be measured on one machine. Element values are passed as their bit patterns, zero-extended to
+/// 64 bits.
+namespace SimdKernels
+{
+    /// The index of the kernels for elements of `element_size` bytes in the arrays of KernelTable.
+    [[nodiscard]] constexpr auto size_index(const size_t element_size) noexcept -> size_t
+    {
+        return element_size == 1 ? 0 : element_size == 2 ? 1 : element_size == 4 ? 2 : 3;
+    }
+
+    /// Whether there are kernels for elements of `element_size` bytes.
+    [[nodiscard]] constexpr auto has_kernels_for_size(const size_t element_size) noexcept -> bool
+    {
+        return element_size == 1 || element_size == 2 || element_size == 4 || element_size == 8;
+    }
+
+    /// The unsigned integer of `size` bytes holding the bit pattern of an element.
+    template <size_t size>
+    using Lane = std::conditional_t<
+        size == 1, uint8_t,
+        std::conditional_t<size == 2, uint16_t, std::conditional_t<size == 4, uint32_t, uint64_t>>>;
+
+    /// The bit pattern of `value`, zero-extended to 64 bits, as passed to the kernels.
+    template <typename Element>
+        requires(std::is_trivially_copyable_v<Element> && has_kernels_for_size(sizeof(Element)))
+    [[nodiscard]] constexpr auto bit_pattern(const Element& value) noexcept -> uint64_t
+    {
+        return std::bit_cast<Lane<sizeof(Element)>>(value);
+    }
+
+    using FillKernel = void (*)(std::byte* destination, Int count, uint64_t value) noexcept;
+    using EqualKernel = bool (*)(const std::byte* a, const std::byte* b, size_t size) noexcept;
+    /// Returns the index of the first element equal to `value`, or `count` if there is none.
+    using FindKernel = Int (*)(const std::byte* elements, Int count, uint64_t value) noexcept;
+    /// Returns the number of elements equal to `value`.
+    using CountKernel = Int (*)(const std::byte* elements, Int count, uint64_t value) noexcept;
+    /// Stores the smallest and the largest of `count` > 0 signed integers to `minimum` and `maximum`.
+    ///
+    /// Works on bytes, so that any signed integer type of the kernel's size can be passed without aliasing violations.
+    using MinMaxKernel = void (*)(const std::byte* elements, Int count, std::byte* minimum,
+                                  std::byte* maximum) noexcept;
+
+    /// The kernels for one instruction set. Arrays of kernels are indexed by `size_index` of the element size.
+    struct KernelTable
+    {
+        const char* name;
+        std::array<FillKernel, 4> fill;
+        EqualKernel equal;
+        std::array<FindKernel, 4> find;
+        std::array<CountKernel, 4> count;
+        MinMaxKernel min_max_i32;
+        MinMaxKernel min_max_i64;
+    };
+
+    /// Portable kernels, left to the auto-vectorizer of the baseline target.
+    extern const KernelTable scalar_kernels;
+
+#ifdef CPP_MVS_X86_KERNELS
+    extern const KernelTable sse42_kernels;
+    extern const KernelTable avx2_kernels;
+    /// Requires AVX-512F and AVX-512BW.
+    extern const KernelTable avx512_kernels;
+#endif
+
+    /// The instruction sets with kernels, from the least to the most capable.
+    enum class InstructionSet
+    {
+        scalar,
+        sse42,
+        avx2,
+        /// AVX-512F and AVX-512BW.
+        avx512,
+    };
+
+    inline constexpr std::array all_instruction_sets = {InstructionSet::scalar, InstructionSet::sse42,
+                                                        InstructionSet::avx2, InstructionSet::avx512};
+
+    /// The environment variable naming the instruction set `active` uses, like the `name` of its KernelTable.
+    inline constexpr const char* force_instruction_set_variable = "CPP_MVS_FORCE_ISA";
+
+    /// The kernels for `instruction_set`, or null if this build has none, e.g. for AVX2 on ARM.
+    [[nodiscard]] auto kernels_for(InstructionSet instruction_set) noexcept -> const KernelTable*;
+
+    /// Whether this build has kernels for `instruction_set` and the running CPU can execute them.
+    [[nodiscard]] auto is_supported(InstructionSet instruction_set) noexcept -> bool;
+
+    /// The most capable instruction set for which `is_supported`.
+    [[nodiscard]] auto best_supported() noexcept -> InstructionSet;
+
+    /// The instruction set whose KernelTable has the name `name`, such as "avx2".
+    [[nodiscard]] auto instruction_set_named(std::string_view name) noexcept -> std::optional<InstructionSet>;
+
+    /// The kernels used by the bulk algorithms, for the instruction set named by `CPP_MVS_FORCE_ISA` if it is set and
+    /// for `best_supported()` otherwise.
+    ///
+    /// Chosen once, by the first call, so that later calls only load the table. Requires a forced instruction set to
+    /// be known and supported, as running its kernels would crash otherwise.
+    [[nodiscard]] auto active() noexcept -> const KernelTable&;
+} // namespace SimdKernels
+
+#endif // CPP_MVS_SIMD_KERNELS_HPP
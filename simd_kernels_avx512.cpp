@@ -0,0 +1,104 @@
+// Compiled with -mavx512f -mavx512bw, see simd_kernels_impl.hpp for the restrictions on this translation unit.
+#include "simd_kernels_impl.hpp"
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx512
+    {
+        using Vector = __m512i;
+        static constexpr Int width = 64;
+
+        [[nodiscard]] [[gnu::always_inline]] static auto load(const std::byte* const address) noexcept -> Vector
+        {
+            return _mm512_loadu_si512(address);
+        }
+
+        [[gnu::always_inline]] static void store(std::byte* const address, const Vector vector) noexcept
+        {
+            _mm512_storeu_si512(address, vector);
+        }
+
+        template <size_t size>
+        [[nodiscard]] [[gnu::always_inline]] static auto broadcast(const uint64_t value) noexcept -> Vector
+        {
+            if constexpr (size == 1)
+            {
+                return _mm512_set1_epi8(static_cast<char>(value));
+            }
+            else if constexpr (size == 2)
+            {
+                return _mm512_set1_epi16(static_cast<short>(value));
+            }
+            else if constexpr (size == 4)
+            {
+                return _mm512_set1_epi32(static_cast<int>(value));
+            }
+            else
+            {
+                return _mm512_set1_epi64(static_cast<long long>(value));
+            }
+        }
+
+        /// One bit per lane, from the mask registers.
+        template <size_t size>
+        static constexpr int mask_stride = 1;
+
+        template <size_t size>
+        [[nodiscard]] [[gnu::always_inline]] static auto equal_mask(const Vector a, const Vector b) noexcept
+            -> uint64_t
+        {
+            if constexpr (size == 1)
+            {
+                return _mm512_cmpeq_epi8_mask(a, b);
+            }
+            else if constexpr (size == 2)
+            {
+                return _mm512_cmpeq_epi16_mask(a, b);
+            }
+            else if constexpr (size == 4)
+            {
+                return _mm512_cmpeq_epi32_mask(a, b);
+            }
+            else
+            {
+                return _mm512_cmpeq_epi64_mask(a, b);
+            }
+        }
+
+        [[nodiscard]] [[gnu::always_inline]] static auto all_equal(const Vector a, const Vector b) noexcept -> bool
+        {
+            return _mm512_cmpeq_epi64_mask(a, b) == 0xFF;
+        }
+
+        template <size_t size>
+        [[nodiscard]] [[gnu::always_inline]] static auto min(const Vector a, const Vector b) noexcept -> Vector
+        {
+            if constexpr (size == 4)
+            {
+                return _mm512_min_epi32(a, b);
+            }
+            else
+            {
+                return _mm512_min_epi64(a, b);
+            }
+        }
+
+        template <size_t size>
+        [[nodiscard]] [[gnu::always_inline]] static auto max(const Vector a, const Vector b) noexcept -> Vector
+        {
+            if constexpr (size == 4)
+            {
+                return _mm512_max_epi32(a, b);
+            }
+            else
+            {
+                return _mm512_max_epi64(a, b);
+            }
+        }
+    };
+} // namespace
+
+constinit const SimdKernels::KernelTable SimdKernels::avx512_kernels =
+    Implementation::kernel_table<Avx512>("avx512");
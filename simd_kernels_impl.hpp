@@ -0,0 +1,180 @@
+#ifndef CPP_MVS_SIMD_KERNELS_IMPL_HPP
+#define CPP_MVS_SIMD_KERNELS_IMPL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "simd_kernels.hpp"
+
+/// The kernels written once over a vector instruction set `Isa`, and instantiated by the translation unit compiled
+/// for that instruction set.
+///
+/// `Isa` provides:
+/// - `Vector`, and `width`, the size of a Vector in bytes,
+/// - `load(const std::byte*)` and `store(std::byte*, Vector)`, both unaligned,
+/// - `broadcast<size>(uint64_t)`, filling all lanes of `size` bytes with the value,
+/// - `equal_mask<size>(Vector, Vector)`, a bit mask of the equal lanes with `mask_stride<size>` bits per lane,
+/// - `all_equal(Vector, Vector)`,
+/// - `min<size>(Vector, Vector)` and `max<size>(Vector, Vector)` of signed lanes of 4 and 8 bytes.
+///
+/// Warning: The including translation units are compiled for instruction sets the running CPU may lack. Each defines
+/// its `Isa` in an anonymous namespace, so that every instantiation here has internal linkage, and nothing here calls
+/// inline functions of other headers, such as the standard library's, so that the linker cannot pick a copy compiled
+/// for a missing instruction set for the rest of the program.
+namespace SimdKernels::Implementation
+{
+    template <typename Isa, size_t size>
+    [[nodiscard]] [[gnu::always_inline]] inline auto load_lane(const std::byte* const address) noexcept -> Lane<size>
+    {
+        Lane<size> lane;
+        __builtin_memcpy(&lane, address, size);
+        return lane;
+    }
+
+    template <typename Isa, size_t size>
+    void fill(std::byte* const destination, const Int count, const uint64_t value) noexcept
+    {
+        const auto pattern = Isa::template broadcast<size>(value);
+        constexpr Int lanes = Isa::width / size;
+        Int i = 0;
+        for (; i + lanes <= count; i += lanes)
+        {
+            Isa::store(destination + (i * size), pattern);
+        }
+        const auto lane = static_cast<Lane<size>>(value);
+        for (; i < count; ++i)
+        {
+            __builtin_memcpy(destination + (i * size), &lane, size);
+        }
+    }
+
+    template <typename Isa>
+    auto equal(const std::byte* const a, const std::byte* const b, const size_t size) noexcept -> bool
+    {
+        size_t i = 0;
+        for (; i + Isa::width <= size; i += Isa::width)
+        {
+            if (!Isa::all_equal(Isa::load(a + i), Isa::load(b + i)))
+            {
+                return false;
+            }
+        }
+        return __builtin_memcmp(a + i, b + i, size - i) == 0;
+    }
+
+    template <typename Isa, size_t size>
+    auto find(const std::byte* const elements, const Int count, const uint64_t value) noexcept -> Int
+    {
+        const auto needle = Isa::template broadcast<size>(value);
+        constexpr Int lanes = Isa::width / size;
+        Int i = 0;
+        for (; i + lanes <= count; i += lanes)
+        {
+            const uint64_t mask = Isa::template equal_mask<size>(Isa::load(elements + (i * size)), needle);
+            if (mask != 0)
+            {
+                return i + (__builtin_ctzll(mask) / Isa::template mask_stride<size>);
+            }
+        }
+        const auto lane = static_cast<Lane<size>>(value);
+        for (; i < count; ++i)
+        {
+            if (load_lane<Isa, size>(elements + (i * size)) == lane)
+            {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    template <typename Isa, size_t size>
+    auto count(const std::byte* const elements, const Int count, const uint64_t value) noexcept -> Int
+    {
+        const auto needle = Isa::template broadcast<size>(value);
+        constexpr Int lanes = Isa::width / size;
+        Int matches = 0;
+        Int i = 0;
+        for (; i + lanes <= count; i += lanes)
+        {
+            const uint64_t mask = Isa::template equal_mask<size>(Isa::load(elements + (i * size)), needle);
+            matches += __builtin_popcountll(mask) / Isa::template mask_stride<size>;
+        }
+        const auto lane = static_cast<Lane<size>>(value);
+        for (; i < count; ++i)
+        {
+            matches += load_lane<Isa, size>(elements + (i * size)) == lane ? 1 : 0;
+        }
+        return matches;
+    }
+
+    template <typename Isa, typename Integer>
+    [[nodiscard]] [[gnu::always_inline]] inline auto load_integer(const std::byte* const address) noexcept -> Integer
+    {
+        Integer integer;
+        __builtin_memcpy(&integer, address, sizeof(Integer));
+        return integer;
+    }
+
+    template <typename Isa, typename Integer>
+    void min_max(const std::byte* const bytes, const Int count, std::byte* const minimum,
+                 std::byte* const maximum) noexcept
+    {
+        constexpr size_t size = sizeof(Integer);
+        constexpr Int lanes = Isa::width / size;
+        Integer low = load_integer<Isa, Integer>(bytes);
+        Integer high = low;
+        if (count >= lanes)
+        {
+            auto low_vector = Isa::load(bytes);
+            auto high_vector = low_vector;
+            for (Int i = lanes; i + lanes <= count; i += lanes)
+            {
+                const auto vector = Isa::load(bytes + (i * size));
+                low_vector = Isa::template min<size>(low_vector, vector);
+                high_vector = Isa::template max<size>(high_vector, vector);
+            }
+            // The last, possibly overlapping vector covers the remaining elements.
+            const auto last = Isa::load(bytes + ((count - lanes) * size));
+            low_vector = Isa::template min<size>(low_vector, last);
+            high_vector = Isa::template max<size>(high_vector, last);
+
+            Integer low_lanes[lanes];
+            Integer high_lanes[lanes];
+            Isa::store(reinterpret_cast<std::byte*>(low_lanes), low_vector);
+            Isa::store(reinterpret_cast<std::byte*>(high_lanes), high_vector);
+            for (Int lane = 0; lane < lanes; ++lane)
+            {
+                low = low_lanes[lane] < low ? low_lanes[lane] : low;
+                high = high_lanes[lane] > high ? high_lanes[lane] : high;
+            }
+        }
+        else
+        {
+            for (Int i = 1; i < count; ++i)
+            {
+                const auto element = load_integer<Isa, Integer>(bytes + (i * size));
+                low = element < low ? element : low;
+                high = element > high ? element : high;
+            }
+        }
+        __builtin_memcpy(minimum, &low, size);
+        __builtin_memcpy(maximum, &high, size);
+    }
+
+    /// The table of the kernels of `Isa`, named `name`.
+    template <typename Isa>
+    [[nodiscard]] constexpr auto kernel_table(const char* const name) noexcept -> KernelTable
+    {
+        return {
+            .name = name,
+            .fill = {fill<Isa, 1>, fill<Isa, 2>, fill<Isa, 4>, fill<Isa, 8>},
+            .equal = equal<Isa>,
+            .find = {find<Isa, 1>, find<Isa, 2>, find<Isa, 4>, find<Isa, 8>},
+            .count = {count<Isa, 1>, count<Isa, 2>, count<Isa, 4>, count<Isa, 8>},
+            .min_max_i32 = min_max<Isa, int32_t>,
+            .min_max_i64 = min_max<Isa, int64_t>,
+        };
+    }
+} // namespace SimdKernels::Implementation
+
+#endif // CPP_MVS_SIMD_KERNELS_IMPL_HPP
@@ -0,0 +1,106 @@
+// Compiled with -msse4.2, see simd_kernels_impl.hpp for the restrictions on this translation unit.
+#include "simd_kernels_impl.hpp"
+
+#include <immintrin.h>
+
+namespace
+{
+    struct Sse42
+    {
+        using Vector = __m128i;
+        static constexpr Int width = 16;
+
+        [[nodiscard]] [[gnu::always_inline]] static auto load(const std::byte* const address) noexcept -> Vector
+        {
+            return _mm_loadu_si128(reinterpret_cast<const Vector*>(address));
+        }
+
+        [[gnu::always_inline]] static void store(std::byte* const address, const Vector vector) noexcept
+        {
+            _mm_storeu_si128(reinterpret_cast<Vector*>(address), vector);
+        }
+
+        template <size_t size>
+        [[nodiscard]] [[gnu::always_inline]] static auto broadcast(const uint64_t value) noexcept -> Vector
+        {
+            if constexpr (size == 1)
+            {
+                return _mm_set1_epi8(static_cast<char>(value));
+            }
+            else if constexpr (size == 2)
+            {
+                return _mm_set1_epi16(static_cast<short>(value));
+            }
+            else if constexpr (size == 4)
+            {
+                return _mm_set1_epi32(static_cast<int>(value));
+            }
+            else
+            {
+                return _mm_set1_epi64x(static_cast<long long>(value));
+            }
+        }
+
+        /// One bit per byte, as there are no lane-wise masks before AVX-512.
+        template <size_t size>
+        static constexpr int mask_stride = size;
+
+        template <size_t size>
+        [[nodiscard]] [[gnu::always_inline]] static auto equal_mask(const Vector a, const Vector b) noexcept
+            -> uint64_t
+        {
+            Vector equal;
+            if constexpr (size == 1)
+            {
+                equal = _mm_cmpeq_epi8(a, b);
+            }
+            else if constexpr (size == 2)
+            {
+                equal = _mm_cmpeq_epi16(a, b);
+            }
+            else if constexpr (size == 4)
+            {
+                equal = _mm_cmpeq_epi32(a, b);
+            }
+            else
+            {
+                equal = _mm_cmpeq_epi64(a, b);
+            }
+            return static_cast<uint32_t>(_mm_movemask_epi8(equal));
+        }
+
+        [[nodiscard]] [[gnu::always_inline]] static auto all_equal(const Vector a, const Vector b) noexcept -> bool
+        {
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0xFFFF;
+        }
+
+        template <size_t size>
+        [[nodiscard]] [[gnu::always_inline]] static auto min(const Vector a, const Vector b) noexcept -> Vector
+        {
+            if constexpr (size == 4)
+            {
+                return _mm_min_epi32(a, b);
+            }
+            else
+            {
+                return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b));
+            }
+        }
+
+        template <size_t size>
+        [[nodiscard]] [[gnu::always_inline]] static auto max(const Vector a, const Vector b) noexcept -> Vector
+        {
+            if constexpr (size == 4)
+            {
+                return _mm_max_epi32(a, b);
+            }
+            else
+            {
+                return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b));
+            }
+        }
+    };
+} // namespace
+
+constinit const SimdKernels::KernelTable SimdKernels::sse42_kernels =
+    Implementation::kernel_table<Sse42>("sse4.2");
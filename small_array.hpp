@@ -0,0 +1,245 @@
+#ifndef CPP_MVS_SMALL_ARRAY_HPP
+#define CPP_MVS_SMALL_ARRAY_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <new>
+#include "flexible_array_checked.hpp"
+#include "library.h"
+
+/// A growable array storing up to `inline_capacity` elements inside the object, without heap allocation.
+///
+/// Appending beyond the inline capacity moves all elements into heap storage acquired from `Allocator`, which holds the
+/// capacity in its header. The array never moves back to the inline buffer, so that repeatedly crossing the inline
+/// capacity does not allocate repeatedly.
+///
+/// Unlike Array, copies are eager: small arrays are expected to be cheap to copy element by element.
+template <typename Element, Int inline_capacity, StorageAllocator Allocator = DefaultAllocator>
+    requires std::movable<Element> && std::destructible<Element> && (inline_capacity > 0)
+class SmallArray
+{
+    struct Header
+    {
+        Int capacity;
+
+        [[nodiscard]] explicit Header(const Int capacity) noexcept : capacity(capacity) {}
+
+        /// Returns the number of elements of the storage (capacity)
+        ///
+        /// Satisfies TrailingElementCountProvider concept.
+        [[nodiscard]] Int trailing_element_count() const { return capacity; }
+    };
+    static_assert(TrailingElementCountProvider<Header>);
+
+    using Storage = FlexibleArrayChecked<Header, Element, Allocator>;
+
+    /// The number of initialized elements, either in the inline buffer or in the heap storage.
+    Int count_ = 0;
+
+    /// The heap storage of the elements, invalid while they fit in the inline buffer.
+    Storage heap_storage = Storage::create_empty();
+
+    /// The space for the elements while the array is inline.
+    alignas(Element) std::byte inline_buffer[sizeof(Element) * inline_capacity];
+
+    [[nodiscard]] explicit SmallArray() noexcept = default;
+
+    /// Returns the address for the place of the `i`th element, wherever the elements currently live.
+    ///
+    /// Requires 0 <= `i` < `capacity()`.
+    template <typename Self>
+    [[nodiscard]] constexpr auto element_address(this Self&& self, const Int i) noexcept
+        -> const_pointee_like<Self, Element*>
+    {
+        if (self.heap_storage.is_valid())
+        {
+            return self.heap_storage.element_address(i);
+        }
+        if constexpr (bounds_checks_enabled)
+        {
+            precondition(i >= 0 && i < inline_capacity, "Index out of bounds");
+        }
+        return std::launder(reinterpret_cast<const_pointee_like<Self, Element*>>(self.inline_buffer)) + i;
+    }
+
+    /// The capacity to grow to so that at least `minimum_capacity` elements fit, growing geometrically.
+    [[nodiscard]] constexpr auto grown_capacity(const Int minimum_capacity) const noexcept -> Int
+    {
+        return std::max(minimum_capacity, capacity() * 2);
+    }
+
+    /// Moves the elements into `destination` one by one, leaving the array without live elements.
+    ///
+    /// Requires `destination` to have space for at least `count()` elements.
+    void relocate_elements_into(Storage& destination) noexcept
+    {
+        for (Int i = 0; i < count_; ++i)
+        {
+            Element* source = element_address(i);
+            std::construct_at(destination.element_address(i), std::move(*source));
+            std::destroy_at(source);
+        }
+    }
+
+    /// Destroys all elements, keeping the storage.
+    void destroy_elements() noexcept
+    {
+        for (Int i = 0; i < count_; ++i)
+        {
+            std::destroy_at(element_address(i));
+        }
+        count_ = 0;
+    }
+
+    /// Takes over the elements of `other`, stealing its heap storage or moving its inline elements one by one.
+    ///
+    /// Requires this array to be empty and inline. Leaves `other` empty.
+    void take_elements_of(SmallArray& other) noexcept
+    {
+        if (other.heap_storage.is_valid())
+        {
+            heap_storage = std::move(other.heap_storage);
+        }
+        else
+        {
+            for (Int i = 0; i < other.count_; ++i)
+            {
+                Element* source = other.element_address(i);
+                std::construct_at(element_address(i), std::move(*source));
+                std::destroy_at(source);
+            }
+        }
+        count_ = std::exchange(other.count_, 0);
+    }
+
+public:
+    /// Creates an empty array using its inline buffer, with no heap allocation.
+    [[nodiscard]] static auto create_empty() noexcept -> SmallArray { return SmallArray{}; }
+
+    /// The number of initialized elements in the array.
+    [[nodiscard]] constexpr auto count() const noexcept -> Int { return count_; }
+
+    /// The number of elements the array currently has space for, which is `inline_capacity` until it spills.
+    [[nodiscard]] constexpr auto capacity() const noexcept -> Int
+    {
+        return heap_storage.is_valid() ? heap_storage.capacity() : inline_capacity;
+    }
+
+    /// Whether the elements are stored in the inline buffer rather than on the heap.
+    [[nodiscard]] constexpr auto is_inline() const noexcept -> bool { return !heap_storage.is_valid(); }
+
+    /// Returns the `index`th element.
+    ///
+    /// Requires 0 <= `index` < `count()`.
+    [[nodiscard]] constexpr auto operator[](const Int index) const noexcept -> const Element&
+    {
+        precondition(index >= 0 && index < count(), "Index out of bounds");
+        return *element_address(index);
+    }
+
+    /// Returns the `index`th element for mutation.
+    ///
+    /// Requires 0 <= `index` < `count()`.
+    [[nodiscard]] constexpr auto operator[](const Int index) noexcept -> Element&
+    {
+        precondition(index >= 0 && index < count(), "Index out of bounds");
+        return *element_address(index);
+    }
+
+    /// Ensures that the array has space for at least `minimum_capacity` elements without further allocation.
+    ///
+    /// Never shrinks the storage, and never allocates while `minimum_capacity` fits in the inline buffer.
+    void reserve(const Int minimum_capacity) noexcept
+    {
+        if (minimum_capacity <= capacity())
+        {
+            return;
+        }
+        auto new_storage = Storage::with_header(minimum_capacity, Header{minimum_capacity});
+        relocate_elements_into(new_storage);
+        heap_storage = std::move(new_storage);
+    }
+
+    /// Constructs a new element from `arguments` at the end of the array, returning a reference to it.
+    ///
+    /// Spills to the heap when the inline buffer is full, then grows geometrically.
+    template <typename... Arguments>
+        requires std::constructible_from<Element, Arguments...>
+    auto emplace_back(Arguments&&... arguments) -> Element&
+    {
+        if (count_ < capacity())
+        {
+            Element* place = std::construct_at(element_address(count_), std::forward<Arguments>(arguments)...);
+            ++count_;
+            return *place;
+        }
+
+        // The new element is constructed before relocating the old ones, as `arguments` may refer to them.
+        const Int new_capacity = grown_capacity(count_ + 1);
+        auto new_storage = Storage::with_header(new_capacity, Header{new_capacity});
+        Element* place = std::construct_at(new_storage.element_address(count_), std::forward<Arguments>(arguments)...);
+        relocate_elements_into(new_storage);
+        heap_storage = std::move(new_storage);
+        ++count_;
+        return *place;
+    }
+
+    /// Appends a copy of `element` to the end of the array.
+    void append(const Element& element)
+        requires std::copy_constructible<Element>
+    {
+        emplace_back(element);
+    }
+
+    /// Appends `element` to the end of the array by moving it.
+    void append(Element&& element) { emplace_back(std::move(element)); }
+
+    /// Copy constructor, copying the elements into the inline buffer if they fit, or into a heap storage otherwise.
+    ///
+    /// Delegates to the default constructor, so that the destructor destroys the elements already copied if copying
+    /// the next one throws.
+    SmallArray(const SmallArray& other)
+        requires std::copy_constructible<Element>
+        : SmallArray()
+    {
+        reserve(other.count_);
+        for (; count_ < other.count_; ++count_)
+        {
+            std::construct_at(element_address(count_), other[count_]);
+        }
+    }
+
+    /// Copy assignment operator, replacing the elements with copies of the elements of `other`.
+    SmallArray& operator=(const SmallArray& other)
+        requires std::copy_constructible<Element>
+    {
+        if (this != &other)
+        {
+            *this = SmallArray{other};
+        }
+        return *this;
+    }
+
+    /// Move constructor, leaving `other` empty.
+    ///
+    /// Steals the heap storage of `other`, or moves its inline elements one by one.
+    SmallArray(SmallArray&& other) noexcept { take_elements_of(other); }
+
+    /// Move assignment operator, destroying the elements held before the assignment.
+    SmallArray& operator=(SmallArray&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy_elements();
+            heap_storage = Storage::create_empty();
+            take_elements_of(other);
+        }
+        return *this;
+    }
+
+    /// Destroys the elements, and frees the heap storage if the array has spilled.
+    ~SmallArray() { destroy_elements(); }
+};
+
+#endif // CPP_MVS_SMALL_ARRAY_HPP
@@ -0,0 +1,312 @@
+#ifndef CPP_MVS_SOA_ARRAY_HPP
+#define CPP_MVS_SOA_ARRAY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <utility>
+#include "flexible_array_multi.hpp"
+#include "library.h"
+
+namespace Detail
+{
+    /// Converts to anything, for counting the fields of an aggregate in unevaluated contexts.
+    struct AnyField
+    {
+        template <typename T>
+        operator T() const; // NOLINT(google-explicit-constructor)
+    };
+
+    /// Whether `Record` can be initialized from as many values as `indices`.
+    ///
+    /// Each value is braced, so that an array field takes one value rather than one per element.
+    template <typename Record, size_t... indices>
+    consteval auto is_initializable_from_fields(std::index_sequence<indices...> /*indices*/) -> bool
+    {
+        return requires { Record{{(static_cast<void>(indices), AnyField{})}...}; };
+    }
+
+    /// The number of fields of the aggregate `Record`, found by initializing it from more and more values.
+    template <typename Record, size_t count = 0>
+    consteval auto aggregate_field_count() -> size_t
+    {
+        if constexpr (is_initializable_from_fields<Record>(std::make_index_sequence<count + 1>{}))
+        {
+            return aggregate_field_count<Record, count + 1>();
+        }
+        else
+        {
+            return count;
+        }
+    }
+
+    /// The largest number of fields `fields_of` can decompose.
+    inline constexpr size_t max_decomposed_fields = 8;
+
+    /// A tuple of references to the fields of the aggregate `record`, in declaration order.
+    template <typename Record>
+    constexpr auto fields_of(Record& record) noexcept
+    {
+        constexpr size_t count = aggregate_field_count<std::remove_const_t<Record>>();
+        static_assert(count > 0 && count <= max_decomposed_fields, "Unsupported number of fields");
+        if constexpr (count == 1)
+        {
+            auto& [f0] = record;
+            return std::tie(f0);
+        }
+        else if constexpr (count == 2)
+        {
+            auto& [f0, f1] = record;
+            return std::tie(f0, f1);
+        }
+        else if constexpr (count == 3)
+        {
+            auto& [f0, f1, f2] = record;
+            return std::tie(f0, f1, f2);
+        }
+        else if constexpr (count == 4)
+        {
+            auto& [f0, f1, f2, f3] = record;
+            return std::tie(f0, f1, f2, f3);
+        }
+        else if constexpr (count == 5)
+        {
+            auto& [f0, f1, f2, f3, f4] = record;
+            return std::tie(f0, f1, f2, f3, f4);
+        }
+        else if constexpr (count == 6)
+        {
+            auto& [f0, f1, f2, f3, f4, f5] = record;
+            return std::tie(f0, f1, f2, f3, f4, f5);
+        }
+        else if constexpr (count == 7)
+        {
+            auto& [f0, f1, f2, f3, f4, f5, f6] = record;
+            return std::tie(f0, f1, f2, f3, f4, f5, f6);
+        }
+        else
+        {
+            auto& [f0, f1, f2, f3, f4, f5, f6, f7] = record;
+            return std::tie(f0, f1, f2, f3, f4, f5, f6, f7);
+        }
+    }
+
+    template <typename... Fields>
+    auto field_types_of(std::tuple<Fields&...> /*fields*/) -> std::tuple<Fields...>;
+
+    /// The tuple of the field types of the aggregate `Record`.
+    template <typename Record>
+    using FieldTypes = decltype(field_types_of(fields_of(std::declval<Record&>())));
+
+    template <typename Record, typename... Fields>
+    consteval auto is_initializable_from_values(std::tuple<Fields...>* /*fields*/) -> bool
+    {
+        return requires { Record{std::declval<Fields>()...}; };
+    }
+
+    /// Whether the aggregate `Record` can be initialized from values of its field types, as gathering it from columns
+    /// does.
+    ///
+    /// Array fields cannot be initialized from an array value, and reference fields cannot bind to one.
+    template <typename Record>
+    inline constexpr bool is_initializable_from_field_values =
+        is_initializable_from_values<Record>(static_cast<FieldTypes<Record>*>(nullptr));
+
+    /// Whether `field` is the very object `target` refers to.
+    template <typename Field, typename Target>
+    constexpr auto is_same_object(const Field& field, const Target& target) noexcept -> bool
+    {
+        if constexpr (std::is_same_v<Field, Target>)
+        {
+            return std::addressof(field) == std::addressof(target);
+        }
+        else
+        {
+            return false;
+        }
+    }
+} // namespace Detail
+
+/// A simple aggregate that SoAArray can split into columns.
+///
+/// Its fields are trivially copyable, neither arrays nor references, and at most `Detail::max_decomposed_fields`. It can
+/// be value-initialized in constant expressions, which lets member pointers be mapped to columns at compile time.
+template <typename Record>
+concept SoARecord = std::is_aggregate_v<Record> && std::is_trivially_copyable_v<Record> &&
+                    requires { std::bool_constant<(Record{}, true)>::value; };
+
+/// A growable array of aggregates stored as one column per field, all in a single FlexibleArrayMulti allocation.
+///
+/// Scanning one field reads only that field's column, so filters over a few fields of many records use every byte of
+/// the cache lines they load, and the columns can be processed with SIMD. Whole records are gathered from and
+/// scattered to the columns.
+///
+/// An empty SoAArray holds no storage unless capacity was reserved for it.
+template <SoARecord Record>
+class SoAArray
+{
+    static_assert(Detail::is_initializable_from_field_values<Record>,
+                  "The fields of a SoARecord cannot be arrays or references");
+
+    using Fields = Detail::FieldTypes<Record>;
+    static constexpr size_t field_count = std::tuple_size_v<Fields>;
+
+    struct Header
+    {
+        Int count;
+        Int capacity;
+
+        /// Satisfies TrailingElementCountsProvider concept: every column has space for `capacity` fields.
+        [[nodiscard]] auto trailing_element_counts() const -> std::array<Int, field_count>
+        {
+            std::array<Int, field_count> counts{};
+            counts.fill(capacity);
+            return counts;
+        }
+    };
+
+    template <typename FieldTuple>
+    struct StorageFor;
+
+    template <typename... FieldTypes>
+    struct StorageFor<std::tuple<FieldTypes...>>
+    {
+        using Type = FlexibleArrayMulti<Header, FieldTypes...>;
+    };
+
+    using Storage = typename StorageFor<Fields>::Type;
+
+    /// The capacity of the first allocation made by a growing append.
+    static constexpr Int minimum_grown_capacity = 4;
+
+    /// The columns, invalid when the array is empty, unless capacity was reserved for it.
+    Storage storage = Storage::create_empty();
+
+    /// The column holding the field `member` points to.
+    template <auto member>
+    [[nodiscard]] static consteval auto column_index() -> size_t
+    {
+        constexpr Record probe{};
+        const auto fields = Detail::fields_of(probe);
+        size_t index = field_count;
+        [&]<size_t... indices>(std::index_sequence<indices...>)
+        {
+            ((Detail::is_same_object(std::get<indices>(fields), probe.*member) ? (index = indices) : 0), ...);
+        }(std::make_index_sequence<field_count>{});
+        return index;
+    }
+
+    /// Moves the columns into a new storage with space for `new_capacity` records.
+    void relocate_to(const Int new_capacity) noexcept
+    {
+        const Int record_count = count();
+        auto new_storage = Storage::with_header(Header{record_count, new_capacity});
+        if (storage.is_valid())
+        {
+            const auto destinations = new_storage.all_elements_start();
+            const auto sources = std::as_const(storage).all_elements_start();
+            [&]<size_t... indices>(std::index_sequence<indices...>)
+            {
+                (std::memcpy(std::get<indices>(destinations), std::get<indices>(sources),
+                             sizeof(std::tuple_element_t<indices, Fields>) * static_cast<size_t>(record_count)),
+                 ...);
+            }(std::make_index_sequence<field_count>{});
+        }
+        storage = std::move(new_storage);
+    }
+
+public:
+    /// Creates an empty array with no heap allocation.
+    [[nodiscard]] static auto create_empty() noexcept -> SoAArray { return SoAArray{}; }
+
+    /// The number of records in the array.
+    [[nodiscard]] auto count() const noexcept -> Int { return storage.is_valid() ? storage.header()->count : 0; }
+
+    /// The number of records the array has allocated space for.
+    [[nodiscard]] auto capacity() const noexcept -> Int { return storage.is_valid() ? storage.header()->capacity : 0; }
+
+    /// Whether the array has no records.
+    [[nodiscard]] auto empty() const noexcept -> bool { return count() == 0; }
+
+    /// Ensures that the array has space for at least `minimum_capacity` records without further allocation.
+    ///
+    /// Never shrinks the storage. An empty array allocates columns of no records.
+    void reserve(const Int minimum_capacity) noexcept
+    {
+        if (minimum_capacity > capacity())
+        {
+            relocate_to(minimum_capacity);
+        }
+    }
+
+    /// Appends `record` to the end of the array, scattering its fields to the columns.
+    ///
+    /// Grows the storage geometrically when it is full, so that appending is amortized O(1).
+    void append(const Record& record) noexcept
+    {
+        const Int old_count = count();
+        if (old_count == capacity())
+        {
+            relocate_to(std::max({old_count + 1, capacity() * 2, minimum_grown_capacity}));
+        }
+        storage.header()->count = old_count + 1;
+        set(old_count, record);
+    }
+
+    /// Gathers the `index`th record from the columns.
+    ///
+    /// Reading a single field this way, e.g. `array[i].price`, only loads that field once optimized.
+    /// Requires 0 <= `index` < `count()`.
+    [[nodiscard]] auto operator[](const Int index) const noexcept -> Record
+    {
+        precondition(index >= 0 && index < count(), "Index out of bounds");
+        const auto columns = storage.all_elements_start();
+        return [&]<size_t... indices>(std::index_sequence<indices...>)
+        {
+            return Record{std::get<indices>(columns)[index]...};
+        }(std::make_index_sequence<field_count>{});
+    }
+
+    /// Scatters the fields of `record` to the `index`th place of the columns.
+    ///
+    /// Requires 0 <= `index` < `count()`.
+    void set(const Int index, const Record& record) noexcept
+    {
+        precondition(index >= 0 && index < count(), "Index out of bounds");
+        const auto fields = Detail::fields_of(record);
+        const auto columns = storage.all_elements_start();
+        [&]<size_t... indices>(std::index_sequence<indices...>)
+        {
+            ((std::get<indices>(columns)[index] = std::get<indices>(fields)), ...);
+        }(std::make_index_sequence<field_count>{});
+    }
+
+    /// Returns the field `member` points to of the `index`th record.
+    ///
+    /// Requires 0 <= `index` < `count()`.
+    template <auto member, typename Self>
+    [[nodiscard]] auto field(this Self&& self, const Int index) noexcept -> auto&
+    {
+        precondition(index >= 0 && index < self.count(), "Index out of bounds");
+        return self.template column<member>()[static_cast<size_t>(index)];
+    }
+
+    /// Returns the column of the field `member` points to, with one element per record.
+    template <auto member, typename Self>
+    [[nodiscard]] auto column(this Self&& self) noexcept
+    {
+        constexpr size_t index = column_index<member>();
+        static_assert(index < field_count, "The member is not a field of the record");
+        using Field = std::tuple_element_t<index, Fields>;
+        using Column = std::span<const_like<Self, Field>>;
+        if (!self.storage.is_valid())
+        {
+            return Column{};
+        }
+        return Column{self.storage.template elements_start<index>(), static_cast<size_t>(self.count())};
+    }
+};
+
+#endif // CPP_MVS_SOA_ARRAY_HPP
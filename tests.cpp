@@ -1,7 +1,38 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest/doctest.h>
 #include "library.h"
+#include "allocation_tracking.hpp"
 #include "flexible_array_checked.hpp"
+#include "flexible_array_multi.hpp"
+#include "array.hpp"
+#include "bulk_algorithms.hpp"
+#include "monotonic_arena.hpp"
+#include "pool_allocator.hpp"
+#include "reference_counter.hpp"
+#include "scratch_arena.hpp"
+#include "small_array.hpp"
+#include "soa_array.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__)
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 // =============================================================================
 // 1. HELPERS & LIFECYCLE TRACKING
@@ -203,6 +234,182 @@ TEST_SUITE("FlexibleArray Lifecycle") {
     }
 }
 
+TEST_SUITE("Temporary Projection Budget") {
+    TEST_CASE("Temporaries over the stack budget go to the heap") {
+        AllocationTracking::reset();
+
+        // 64 MiB would overflow the stack of most threads.
+        constexpr Int kCount = Int{8} * 1024 * 1024;
+        const Int last = FlexibleArrayUnchecked<StandardHeader, double>::project_temporary(kCount, [&](auto& fa) {
+            std::construct_at(fa.header(), kCount);
+            std::construct_at(fa.element_address(kCount - 1), 2.5);
+            return static_cast<Int>(*fa.element_address(kCount - 1) * 2);
+        });
+        CHECK(last == 5);
+
+        if constexpr (allocation_tracking_enabled) {
+            CHECK(AllocationTracking::statistics().heap_temporary_count == 1);
+        }
+    }
+
+    TEST_CASE("A custom budget moves small temporaries to the heap") {
+        AllocationTracking::reset();
+        LifecycleTracker::reset();
+
+        const int id = FlexibleArrayChecked<TestHeader, double>::project_temporary<0>(3, [](auto& fa) {
+            std::construct_at(fa.header(), 3, 7);
+            CHECK(fa.capacity() == 3);
+            return fa.header()->id;
+        });
+        CHECK(id == 7);
+        CHECK(LifecycleTracker::destroyed == 1);
+
+        if constexpr (allocation_tracking_enabled) {
+            const auto statistics = AllocationTracking::statistics();
+            CHECK(statistics.temporary_count == 1);
+            CHECK(statistics.heap_temporary_count == 1);
+        }
+    }
+
+    TEST_CASE("A throwing consumer releases stack and heap temporaries once") {
+        for (const Int count : {Int{3}, Int{1024} * 1024}) {
+            LifecycleTracker::reset();
+            bool caught = false;
+            try {
+                (void)FlexibleArrayChecked<TestHeader, double>::project_temporary(count, [&](auto& fa) -> int {
+                    std::construct_at(fa.header(), count, 1);
+                    throw std::runtime_error("consumer failed");
+                });
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            CHECK(caught);
+            CHECK(LifecycleTracker::destroyed == 1);
+
+            caught = false;
+            try {
+                (void)FlexibleArrayUnchecked<StandardHeader, double>::project_temporary(count, [&](auto& fa) -> int {
+                    std::construct_at(fa.header(), count);
+                    throw std::runtime_error("consumer failed");
+                });
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            CHECK(caught);
+        }
+    }
+
+    TEST_CASE("Temporaries are aligned for over-aligned elements") {
+        for (const Int count : {Int{2}, Int{1024}}) {
+            const auto address = FlexibleArrayUnchecked<StandardHeader, OverAlignedElement>::project_temporary(
+                count, [&](auto& fa) {
+                    std::construct_at(fa.header(), count);
+                    return reinterpret_cast<uintptr_t>(fa.element_address(0));
+                });
+            CHECK(address % alignof(OverAlignedElement) == 0);
+        }
+    }
+}
+
+// Sums 0..depth-1 with one scratch temporary per recursion level.
+static Int scratch_recursive_sum(const Int depth) {
+    if (depth == 0) {
+        return 0;
+    }
+    using FA = FlexibleArrayChecked<StandardHeader, Int>;
+    return FA::project_scratch_temporary(depth, [&](auto& fa) {
+        std::construct_at(fa.header(), depth);
+        std::construct_at(fa.element_address(depth - 1), depth - 1);
+        const Int rest = scratch_recursive_sum(depth - 1);
+        // The deeper temporaries must not have overwritten this one.
+        return *fa.element_address(depth - 1) + rest;
+    });
+}
+
+TEST_SUITE("ScratchArena") {
+    TEST_CASE("Releasing a marker reuses the memory") {
+        ScratchArena arena;
+        const auto marker = arena.mark();
+        void* first = arena.allocate(100, 16);
+        CHECK(reinterpret_cast<uintptr_t>(first) % 16 == 0);
+        arena.release(marker);
+
+        void* second = arena.allocate(100, 16);
+        CHECK(second == first);
+    }
+
+    TEST_CASE("Chunks are kept across releases") {
+        ScratchArena arena;
+        for (int round = 0; round < 3; ++round) {
+            const ScratchArena::Scope scope{arena};
+            for (int i = 0; i < 100; ++i) {
+                void* block = arena.allocate(4096, 64);
+                CHECK(reinterpret_cast<uintptr_t>(block) % 64 == 0);
+                std::memset(block, 0xab, 4096);
+            }
+        }
+        const size_t reserved = arena.reserved_bytes();
+        CHECK(reserved >= 100 * 4096);
+
+        {
+            const ScratchArena::Scope scope{arena};
+            for (int i = 0; i < 100; ++i) {
+                (void)arena.allocate(4096, 64);
+            }
+        }
+        CHECK(arena.reserved_bytes() == reserved);
+
+        arena.trim();
+        CHECK(arena.reserved_bytes() == 0);
+    }
+
+    TEST_CASE("Nested scratch temporaries in deep recursion") {
+        constexpr Int kDepth = 2000;
+        CHECK(scratch_recursive_sum(kDepth) == kDepth * (kDepth - 1) / 2);
+    }
+
+    TEST_CASE("A throwing consumer leaves the arena to release the scratch temporary") {
+        LifecycleTracker::reset();
+        ScratchArena& arena = ScratchArena::for_current_thread();
+        const auto marker = arena.mark();
+        bool caught = false;
+        try {
+            (void)FlexibleArrayChecked<TestHeader, Int>::project_scratch_temporary(16, [](auto& fa) -> Int {
+                std::construct_at(fa.header(), 16, 1);
+                throw std::runtime_error("consumer failed");
+            });
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(LifecycleTracker::destroyed == 1);
+
+        // The scope of the temporary rewound the arena.
+        CHECK(arena.mark().chunk == marker.chunk);
+        CHECK(arena.mark().cursor == marker.cursor);
+    }
+
+    TEST_CASE("Big scratch temporaries and tracking") {
+        AllocationTracking::reset();
+        LifecycleTracker::reset();
+
+        constexpr Int kCount = Int{1024} * 1024;
+        const auto sum = FlexibleArrayUnchecked<TestHeader, OverAlignedElement>::project_scratch_temporary(
+            kCount, [&](auto& fa) {
+                std::construct_at(fa.header(), kCount, 1);
+                CHECK(reinterpret_cast<uintptr_t>(fa.element_address(0)) % alignof(OverAlignedElement) == 0);
+                fa.element_address(kCount - 1)->data[0] = 3;
+                return fa.element_address(kCount - 1)->data[0] + fa.header()->id;
+            });
+        CHECK(sum == 4);
+        CHECK(LifecycleTracker::destroyed == 1);
+
+        if constexpr (allocation_tracking_enabled) {
+            CHECK(AllocationTracking::statistics().scratch_temporary_count == 1);
+        }
+    }
+}
+
 TEST_SUITE("UnsafeBufferPointer") {
     TEST_CASE("Bounds Checking") {
         int data[] = {1, 2, 3};
@@ -215,6 +422,30 @@ TEST_SUITE("UnsafeBufferPointer") {
         // without a death-test harness, which Doctest supports via subcases/forking
         // but is complex to set up in a single file snippet.
     }
+
+    TEST_CASE("Contiguous range of the elements") {
+        static_assert(std::ranges::contiguous_range<UnsafeBufferPointer<int>>);
+        static_assert(std::ranges::contiguous_range<const UnsafeBufferPointer<int>>);
+        static_assert(std::is_same_v<decltype(std::declval<const UnsafeBufferPointer<int>&>().begin()), const int*>);
+
+        int data[] = {5, 3, 9, 1};
+        UnsafeBufferPointer<int> buffer(data, 4);
+        CHECK(buffer.data() == data);
+        CHECK(buffer.end() - buffer.begin() == 4);
+
+        std::ranges::sort(buffer);
+        CHECK(data[0] == 1);
+        CHECK(data[3] == 9);
+
+        int copy[4] = {};
+        std::ranges::copy(std::as_const(buffer), copy);
+        CHECK(copy[2] == 5);
+
+        const std::span<int> view = buffer;
+        CHECK(view.size() == 4);
+        const std::span<const int> const_view = std::as_const(buffer);
+        CHECK(const_view.data() == data);
+    }
 }
 
 TEST_SUITE("FlexibleArrayUnchecked Direct Usage") {
@@ -421,6 +652,73 @@ TEST_SUITE("FlexibleArrayChecked Edge Cases") {
     }
 }
 
+TEST_SUITE("FlexibleArrayChecked Ranges") {
+    TEST_CASE("span covers the requested range") {
+        using FA = FlexibleArrayChecked<StandardHeader, int>;
+        auto fa = FA::with_header(10, StandardHeader{10});
+        std::span<int> all = fa.span();
+        CHECK(all.size() == 10);
+        CHECK(all.data() == fa.element_address(0));
+        for (size_t i = 0; i < all.size(); ++i) {
+            std::construct_at(&all[i], static_cast<int>(i * i));
+        }
+
+        std::span<const int> middle = std::as_const(fa).span(3, 6);
+        REQUIRE(middle.size() == 3);
+        CHECK(middle[0] == 9);
+        CHECK(middle[2] == 25);
+
+        int sum = 0;
+        for (const int value : fa.span(0, 10)) {
+            sum += value;
+        }
+        CHECK(sum == 285);
+    }
+
+    TEST_CASE("Empty ranges are allowed at both ends") {
+        using FA = FlexibleArrayChecked<StandardHeader, double>;
+        auto fa = FA::with_header(4, StandardHeader{4});
+        CHECK(fa.span(0, 0).empty());
+        CHECK(fa.span(4, 4).empty());
+        CHECK(FA::with_header(0, StandardHeader{0}).span().empty());
+    }
+
+    TEST_CASE("The bounds checking policy is the same in every build mode") {
+#ifdef CPP_MVS_BOUNDS_CHECKS
+        // Set by the build, e.g. per configuration for debug_only, and never derived from NDEBUG.
+        static_assert(bounds_checking == BoundsChecking::CPP_MVS_BOUNDS_CHECKS);
+#else
+        static_assert(bounds_checking == BoundsChecking::checked);
+#endif
+        static_assert(bounds_checks_enabled == (bounds_checking == BoundsChecking::checked));
+    }
+
+#if defined(__unix__)
+    TEST_CASE("Ranges outside the storage fail the precondition when bounds are checked") {
+        if constexpr (bounds_checks_enabled) {
+            using FA = FlexibleArrayChecked<StandardHeader, int>;
+            auto fa = FA::with_header(4, StandardHeader{4});
+            const auto exits_with_failure = [&](const Int begin, const Int end) {
+                const pid_t child = fork();
+                if (child == 0) {
+                    std::freopen("/dev/null", "w", stderr);
+                    (void)fa.span(begin, end);
+                    std::_Exit(EXIT_SUCCESS);
+                }
+                int status = 0;
+                waitpid(child, &status, 0);
+                return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE;
+            };
+
+            CHECK(!exits_with_failure(1, 3));
+            CHECK(exits_with_failure(-1, 2));
+            CHECK(exits_with_failure(3, 2));
+            CHECK(exits_with_failure(2, 5));
+        }
+    }
+#endif
+}
+
 TEST_SUITE("FlexibleArrayUnchecked Edge Cases") {
     TEST_CASE("Zero capacity unchecked array") {
         using FA = FlexibleArrayUnchecked<StandardHeader, int>;
@@ -549,211 +847,2255 @@ TEST_SUITE("FlexibleArrayUnchecked Edge Cases") {
     }
 }
 
-TEST_SUITE("Mixed Checked and Unchecked Usage") {
-    TEST_CASE("Convert checked to unchecked and back") {
-        using FAChecked = FlexibleArrayChecked<StandardHeader, int>;
-        using FAUnchecked = FlexibleArrayUnchecked<StandardHeader, int>;
-        
-        auto checked = FAChecked::with_header(3, StandardHeader{3});
-        std::construct_at(checked.element_address(0), 42);
-        
-        // Extract to unchecked
-        auto unchecked = checked.extract_storage();
-        CHECK(*unchecked.element_address(0) == 42);
-        
-        // Wrap back in checked (move into private constructor via factory)
-        auto checked2 = FAChecked::with_header_initialized_by(0, [&](auto*) {
-            // Don't actually initialize, we'll swap
-        });
-        
-        // Since we can't directly construct from unchecked publicly, 
-        // verify the unchecked can still be used independently
-        CHECK(unchecked.header()->trailing_element_count() == 3);
+TEST_SUITE("FlexibleArray Reallocation") {
+    TEST_CASE("reallocate keeps the header and the elements") {
+        using FA = FlexibleArrayUnchecked<StandardHeader, Int>;
+        auto fa = FA::with_header(4, StandardHeader{4});
+        for (Int i = 0; i < 4; ++i) {
+            std::construct_at(fa.element_address(i), i * 7);
+        }
+
+        fa.reallocate(100000);
+        fa.header()->cap = 100000;
+
+        CHECK(fa.header()->trailing_element_count() == 100000);
+        for (Int i = 0; i < 4; ++i) {
+            CHECK(*fa.element_address(i) == i * 7);
+        }
+        std::construct_at(fa.element_address(99999), Int{42});
+        CHECK(*fa.element_address(99999) == 42);
     }
-    
-    TEST_CASE("Checked wraps unchecked without overhead") {
-        using FAChecked = FlexibleArrayChecked<StandardHeader, int>;
-        using FAUnchecked = FlexibleArrayUnchecked<StandardHeader, int>;
-        
-        // Verify that FlexibleArrayChecked has the same size as FlexibleArrayUnchecked
-        // since it should only contain the unchecked storage member
-        CHECK(sizeof(FAChecked) == sizeof(FAUnchecked));
+
+    TEST_CASE("reallocate keeps over-aligned elements aligned") {
+        using FA = FlexibleArrayChecked<StandardHeader, OverAlignedElement>;
+        auto fa = FA::with_header(2, StandardHeader{2});
+        std::construct_at(fa.element_address(1), OverAlignedElement{{'q'}});
+
+        fa.reallocate(50);
+        fa.header()->cap = 50;
+
+        CHECK(fa.capacity() == 50);
+        CHECK(fa.element_address(1)->data[0] == 'q');
+        CHECK(reinterpret_cast<uintptr_t>(fa.element_address(0)) % alignof(OverAlignedElement) == 0);
     }
-}
 
-TEST_SUITE("is_valid() and create_empty() Comprehensive Tests") {
-    TEST_CASE("Empty array move assignment") {
-        using FA = FlexibleArrayChecked<StandardHeader, int>;
-        auto fa1 = FA::with_header(3, StandardHeader{3});
-        auto fa2 = FA::create_empty();
-        
-        CHECK(fa1.is_valid());
-        CHECK(!fa2.is_valid());
-        
-        fa1 = std::move(fa2);
-        CHECK(!fa1.is_valid());
+    TEST_CASE("try_grow_in_place extends the most recent arena block without moving it") {
+        MonotonicArena arena;
+        MonotonicArena::Scope scope{arena};
+        using FA = FlexibleArrayChecked<StandardHeader, char, ArenaAllocator>;
+        auto fa = FA::with_header(1, StandardHeader{1});
+        std::construct_at(fa.element_address(0), 'a');
+        const auto storage_before = fa.storage_address();
+
+        REQUIRE(fa.try_grow_in_place(2));
+        fa.header()->cap = 2;
+        std::construct_at(fa.element_address(1), 'z');
+        CHECK(fa.storage_address() == storage_before);
+        CHECK(*fa.element_address(0) == 'a');
+        CHECK(*fa.element_address(1) == 'z');
     }
-    
-    TEST_CASE("Move from empty to non-empty") {
-        using FA = FlexibleArrayChecked<StandardHeader, int>;
-        auto fa1 = FA::create_empty();
-        auto fa2 = FA::with_header(3, StandardHeader{3});
-        
-        CHECK(!fa1.is_valid());
-        CHECK(fa2.is_valid());
-        
-        fa1 = std::move(fa2);
-        CHECK(fa1.is_valid());
-        CHECK(!fa2.is_valid());
-        CHECK(fa1.capacity() == 3);
+
+    TEST_CASE("A failed try_grow_in_place leaves the storage to reallocate") {
+        using FA = FlexibleArrayChecked<StandardHeader, char>;
+        auto fa = FA::with_header(3, StandardHeader{3});
+        for (Int i = 0; i < 3; ++i) {
+            std::construct_at(fa.element_address(i), static_cast<char>('a' + i));
+        }
+        const auto storage_before = fa.storage_address();
+
+        // The heap never reports room to grow in place, leaving that to realloc.
+        CHECK(!fa.try_grow_in_place(4));
+        CHECK(fa.storage_address() == storage_before);
+        CHECK(fa.capacity() == 3);
+
+        fa.reallocate(Int{1} << 20);
+        fa.header()->cap = Int{1} << 20;
+        for (Int i = 0; i < 3; ++i) {
+            CHECK(*fa.element_address(i) == static_cast<char>('a' + i));
+        }
     }
-    
-    TEST_CASE("Swap with empty array") {
-        using FA = FlexibleArrayChecked<StandardHeader, int>;
-        auto fa1 = FA::with_header(3, StandardHeader{3});
-        auto fa2 = FA::create_empty();
-        
-        CHECK(fa1.is_valid());
-        CHECK(!fa2.is_valid());
-        
-        swap(fa1, fa2);
-        
-        CHECK(!fa1.is_valid());
-        CHECK(fa2.is_valid());
-        CHECK(fa2.capacity() == 3);
+
+    TEST_CASE("Array growth of trivially copyable elements keeps the elements") {
+        auto array = Array<OverAlignedElement>::create_empty();
+        for (int i = 0; i < 100; ++i) {
+            array.append(OverAlignedElement{{static_cast<char>(i)}});
+        }
+        for (int i = 0; i < 100; ++i) {
+            CHECK(array[i].data[0] == static_cast<char>(i));
+        }
     }
-    
-    TEST_CASE("is_valid throughout lifecycle") {
-        using FA = FlexibleArrayChecked<StandardHeader, int>;
-        
-        // Create
-        auto fa = FA::with_header(5, StandardHeader{5});
-        CHECK(fa.is_valid());
-        
-        // Use
-        std::construct_at(fa.element_address(0), 42);
-        CHECK(fa.is_valid());
-        CHECK(*fa.element_address(0) == 42);
-        
-        // Move
-        auto fa2 = std::move(fa);
-        CHECK(!fa.is_valid());
-        CHECK(fa2.is_valid());
-        CHECK(*fa2.element_address(0) == 42);
-        
-        // Extract
-        auto unchecked = fa2.extract_storage();
-        CHECK(!fa2.is_valid());
-        CHECK(unchecked.is_valid());
-        CHECK(*unchecked.element_address(0) == 42);
+}
+
+// Forwards to the DefaultAllocator, recording every allocation and deallocation.
+struct CountingAllocator {
+    static inline int allocations = 0;
+    static inline int deallocations = 0;
+    static inline size_t live_bytes = 0;
+    static void reset() { allocations = 0; deallocations = 0; live_bytes = 0; }
+
+    static void* allocate(size_t size, size_t alignment) {
+        allocations++;
+        live_bytes += size;
+        return DefaultAllocator::allocate(size, alignment);
     }
-    
-    TEST_CASE("Unchecked empty array move assignment") {
-        using FA = FlexibleArrayUnchecked<StandardHeader, int>;
-        auto fa1 = FA::with_header(3, StandardHeader{3});
-        auto fa2 = FA::create_empty();
-        
-        CHECK(fa1.is_valid());
-        CHECK(!fa2.is_valid());
-        
-        fa1 = std::move(fa2);
-        CHECK(!fa1.is_valid());
+    static void deallocate(void* block, size_t size, size_t alignment) {
+        deallocations++;
+        live_bytes -= size;
+        DefaultAllocator::deallocate(block, size, alignment);
     }
-    
-    TEST_CASE("Unchecked swap with empty array") {
-        using FA = FlexibleArrayUnchecked<StandardHeader, int>;
-        auto fa1 = FA::with_header(3, StandardHeader{3});
-        auto fa2 = FA::create_empty();
-        
-        CHECK(fa1.is_valid());
-        CHECK(!fa2.is_valid());
-        
-        swap(fa1, fa2);
-        
-        CHECK(!fa1.is_valid());
-        CHECK(fa2.is_valid());
-        CHECK(fa2.header()->trailing_element_count() == 3);
+};
+static_assert(StorageAllocator<CountingAllocator>);
+static_assert(!ResizingStorageAllocator<CountingAllocator>);
+
+TEST_SUITE("Allocator Policies") {
+    TEST_CASE("FlexibleArrays acquire and release storage through the policy") {
+        CountingAllocator::reset();
+        {
+            using FA = FlexibleArrayChecked<StandardHeader, OverAlignedElement, CountingAllocator>;
+            auto fa = FA::with_header(3, StandardHeader{3});
+            CHECK(CountingAllocator::allocations == 1);
+            CHECK(CountingAllocator::live_bytes >= sizeof(StandardHeader) + 3 * sizeof(OverAlignedElement));
+            CHECK(reinterpret_cast<uintptr_t>(fa.element_address(0)) % alignof(OverAlignedElement) == 0);
+
+            auto moved = std::move(fa);
+            CHECK(CountingAllocator::deallocations == 0);
+        }
+        CHECK(CountingAllocator::deallocations == 1);
+        CHECK(CountingAllocator::live_bytes == 0);
     }
-    
-    TEST_CASE("Multiple create_empty calls") {
-        using FA = FlexibleArrayChecked<StandardHeader, int>;
-        
-        auto fa1 = FA::create_empty();
-        auto fa2 = FA::create_empty();
-        auto fa3 = FA::create_empty();
-        
-        CHECK(!fa1.is_valid());
-        CHECK(!fa2.is_valid());
-        CHECK(!fa3.is_valid());
-        
-        // They should all be independently invalid
-        auto fa4 = std::move(fa1);
-        CHECK(!fa4.is_valid());
+
+    TEST_CASE("reallocate without a resizing policy copies into a new block") {
+        CountingAllocator::reset();
+        {
+            using FA = FlexibleArrayUnchecked<StandardHeader, Int, CountingAllocator>;
+            auto fa = FA::with_header(2, StandardHeader{2});
+            std::construct_at(fa.element_address(1), Int{77});
+
+            CHECK(!fa.try_grow_in_place(64));
+            fa.reallocate(64);
+            fa.header()->cap = 64;
+
+            CHECK(*fa.element_address(1) == 77);
+            CHECK(CountingAllocator::allocations == 2);
+            CHECK(CountingAllocator::deallocations == 1);
+        }
+        CHECK(CountingAllocator::live_bytes == 0);
     }
-    
-    TEST_CASE("Self-move of empty array") {
-        using FA = FlexibleArrayChecked<StandardHeader, int>;
-        auto fa = FA::create_empty();
-        
-        CHECK(!fa.is_valid());
-        
-        fa = std::move(fa);
-        CHECK(!fa.is_valid());
+
+    TEST_CASE("Array uses the policy for all of its storage") {
+        CountingAllocator::reset();
+        {
+            auto array = Array<std::string, CountingAllocator>::create_empty();
+            for (int i = 0; i < 100; ++i) {
+                array.append(std::to_string(i));
+            }
+            CHECK(array[57] == "57");
+            CHECK(CountingAllocator::allocations > 1);
+        }
+        CHECK(CountingAllocator::allocations == CountingAllocator::deallocations);
+        CHECK(CountingAllocator::live_bytes == 0);
     }
-    
-    TEST_CASE("Validity checks with different header types") {
-        struct ComplexHeader {
-            Int cap;
-            int value;
-            ComplexHeader(Int c, int v) : cap(c), value(v) {}
-            [[nodiscard]] Int trailing_element_count() const { return cap; }
+}
+
+TEST_SUITE("Storage Layout") {
+    TEST_CASE("Descriptors report the chosen layout at compile time") {
+        using HeaderFirst = FlexibleArrayUnchecked<StandardHeader, OverAlignedElement>;
+        using Compact = FlexibleArrayUnchecked<StandardHeader, OverAlignedElement, DefaultAllocator, CompactLayout>;
+        static_assert(HeaderFirst::layout.header_placement == HeaderPlacement::leading);
+        static_assert(HeaderFirst::layout.elements_offset() == 64);
+        static_assert(HeaderFirst::layout.padding_bytes(1) == 56);
+        static_assert(Compact::layout.header_placement == HeaderPlacement::trailing);
+        static_assert(Compact::layout.header_offset(3) == 3 * sizeof(OverAlignedElement));
+        static_assert(Compact::layout.storage_size(3) == 3 * sizeof(OverAlignedElement) + sizeof(StandardHeader));
+        static_assert(Compact::layout.padding_bytes(3) == 0);
+
+        // Without padding to save, the compact layout keeps the header first.
+        static_assert(FlexibleArrayChecked<StandardHeader, int, DefaultAllocator, CompactLayout>::layout.header_placement ==
+                      HeaderPlacement::leading);
+        // A trailing header stricter aligned than the elements is padded after them.
+        static_assert(StorageLayoutDescriptor::of<StandardHeader, char>(HeaderPlacement::trailing).storage_size(3) == 16);
+    }
+
+    TEST_CASE("Trailing header follows the elements") {
+        using FA = FlexibleArrayChecked<StandardHeader, OverAlignedElement, CountingAllocator, CompactLayout>;
+        CountingAllocator::reset();
+        {
+            auto fa = FA::with_header(3, StandardHeader{3});
+            CHECK(CountingAllocator::live_bytes == 3 * sizeof(OverAlignedElement) + sizeof(StandardHeader));
+            CHECK(fa.capacity() == 3);
+
+            const auto first = reinterpret_cast<uintptr_t>(fa.element_address(0));
+            CHECK(first % alignof(OverAlignedElement) == 0);
+            CHECK(reinterpret_cast<uintptr_t>(fa.header()) == first + 3 * sizeof(OverAlignedElement));
+
+            for (Int i = 0; i < 3; ++i) {
+                std::construct_at(fa.element_address(i), OverAlignedElement{{static_cast<char>('a' + i)}});
+            }
+            CHECK(fa.element_address(2)->data[0] == 'c');
+            CHECK(fa.header()->cap == 3);
+        }
+        CHECK(CountingAllocator::deallocations == 1);
+        CHECK(CountingAllocator::live_bytes == 0);
+    }
+
+    TEST_CASE("reallocate moves a trailing header with the storage") {
+        {
+            using FA = FlexibleArrayUnchecked<StandardHeader, OverAlignedElement, DefaultAllocator, HeaderLastLayout>;
+            auto fa = FA::with_header(2, StandardHeader{2});
+            std::construct_at(fa.element_address(1), OverAlignedElement{{'q'}});
+
+            fa.reallocate(1000);
+            CHECK(fa.header()->cap == 2);
+            fa.header()->cap = 1000;
+            CHECK(fa.element_address(1)->data[0] == 'q');
+            std::construct_at(fa.element_address(999), OverAlignedElement{{'z'}});
+
+            fa.reallocate(2);
+            CHECK(fa.header()->cap == 1000);
+            fa.header()->cap = 2;
+            CHECK(fa.element_address(1)->data[0] == 'q');
+            CHECK(reinterpret_cast<uintptr_t>(fa.element_address(0)) % alignof(OverAlignedElement) == 0);
+        }
+
+        {
+            // Without a resizing allocator, the storage is copied to a new one.
+            using FA = FlexibleArrayChecked<StandardHeader, Int, CountingAllocator, HeaderLastLayout>;
+            CountingAllocator::reset();
+            {
+                auto fa = FA::with_header(4, StandardHeader{4});
+                for (Int i = 0; i < 4; ++i) {
+                    std::construct_at(fa.element_address(i), i * 3);
+                }
+                fa.reallocate(8);
+                fa.header()->cap = 8;
+                CHECK(CountingAllocator::live_bytes == 9 * sizeof(Int));
+                CHECK(*fa.element_address(3) == 9);
+
+                fa.reallocate(1);
+                fa.header()->cap = 1;
+                CHECK(fa.capacity() == 1);
+                CHECK(*fa.element_address(0) == 0);
+            }
+            CHECK(CountingAllocator::live_bytes == 0);
+        }
+    }
+
+    TEST_CASE("Element pointer layout points to the first element") {
+        using FA = FlexibleArrayUnchecked<StandardHeader, OverAlignedElement, DefaultAllocator, ElementPointerLayout>;
+        static_assert(FA::layout.header_placement == HeaderPlacement::preceding_elements);
+        static_assert(FA::layout.pointer_offset(10) == 64);
+        static_assert(FA::layout.header_offset(10) == 64 - sizeof(StandardHeader));
+        static_assert(FA::layout.storage_size(10) ==
+                      FlexibleArrayUnchecked<StandardHeader, OverAlignedElement>::layout.storage_size(10));
+
+        auto fa = FA::with_header(10, StandardHeader{10});
+        auto* const elements = reinterpret_cast<OverAlignedElement*>(fa.storage_address());
+        CHECK(elements == fa.element_address(0));
+        CHECK(reinterpret_cast<uintptr_t>(elements) % alignof(OverAlignedElement) == 0);
+        CHECK(reinterpret_cast<char*>(fa.header()) == fa.storage_address() - sizeof(StandardHeader));
+        CHECK(fa.header()->cap == 10);
+
+        std::construct_at(&elements[7], OverAlignedElement{{'p'}});
+        CHECK(fa.element_address(7)->data[0] == 'p');
+
+        fa.reallocate(1000);
+        fa.header()->cap = 1000;
+        CHECK(fa.element_address(7)->data[0] == 'p');
+        CHECK(fa.element_address(0) == reinterpret_cast<OverAlignedElement*>(fa.storage_address()));
+
+        auto* const leaked = fa.leak_storage();
+        auto adopted = FA::adopting_storage(leaked);
+        CHECK(adopted.header()->cap == 1000);
+    }
+
+    TEST_CASE("Element pointer layout of elements aligned looser than the header") {
+        using FA = FlexibleArrayChecked<StandardHeader, char, DefaultAllocator, ElementPointerLayout>;
+        static_assert(FA::layout.pointer_offset(3) == sizeof(StandardHeader));
+        static_assert(FA::layout.header_offset(3) == 0);
+
+        const Int capacity = FA::project_temporary(3, [](auto& fa) {
+            std::construct_at(fa.header(), 3);
+            std::construct_at(fa.element_address(2), 'c');
+            CHECK(fa.storage_address() == reinterpret_cast<char*>(fa.header()) + sizeof(StandardHeader));
+            return fa.capacity();
+        });
+        CHECK(capacity == 3);
+    }
+
+    TEST_CASE("Temporaries use the layout of the array") {
+        using FA = FlexibleArrayChecked<StandardHeader, OverAlignedElement, DefaultAllocator, CompactLayout>;
+        const char last = FA::project_temporary(5, [](auto& fa) {
+            std::construct_at(fa.header(), 5);
+            CHECK(reinterpret_cast<uintptr_t>(fa.element_address(0)) % alignof(OverAlignedElement) == 0);
+            std::construct_at(fa.element_address(4), OverAlignedElement{{'e'}});
+            return fa.element_address(4)->data[0];
+        });
+        CHECK(last == 'e');
+
+        const Int capacity = FA::project_scratch_temporary(2, [](auto& fa) {
+            std::construct_at(fa.header(), 2);
+            return fa.capacity();
+        });
+        CHECK(capacity == 2);
+    }
+}
+
+TEST_SUITE("MonotonicArena") {
+    TEST_CASE("Allocations are aligned and bumped from the same chunk") {
+        MonotonicArena arena;
+        auto* first = static_cast<char*>(arena.allocate(24, 8));
+        auto* second = static_cast<char*>(arena.allocate(8, 8));
+        auto* aligned = arena.allocate(100, 64);
+
+        CHECK(second == first + 24);
+        CHECK(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+        CHECK(arena.reserved_bytes() == MonotonicArena::default_initial_chunk_size);
+    }
+
+    TEST_CASE("Allocations larger than a chunk get a chunk of their own") {
+        MonotonicArena arena(256);
+        auto* block = static_cast<char*>(arena.allocate(4096, 16));
+        block[4095] = 'x';
+
+        CHECK(arena.reserved_bytes() >= 4096);
+    }
+
+    TEST_CASE("Reset keeps a chunk and release frees everything") {
+        MonotonicArena arena(256);
+        for (int i = 0; i < 100; ++i) {
+            (void)arena.allocate(64, 16);
+        }
+        CHECK(arena.reserved_bytes() > 256);
+
+        arena.reset();
+        const auto retained = arena.reserved_bytes();
+        CHECK(retained > 0);
+        (void)arena.allocate(64, 16);
+        CHECK(arena.reserved_bytes() == retained);
+
+        arena.release();
+        CHECK(arena.reserved_bytes() == 0);
+    }
+
+    TEST_CASE("Only the most recent allocation can be resized in place") {
+        MonotonicArena arena;
+        void* first = arena.allocate(16, 8);
+        void* second = arena.allocate(16, 8);
+
+        CHECK(!arena.try_resize_in_place(first, 32));
+        CHECK(arena.try_resize_in_place(second, 32));
+        CHECK(static_cast<char*>(arena.allocate(8, 8)) == static_cast<char*>(second) + 32);
+    }
+
+    TEST_CASE("FlexibleArrays carve their storage from the installed arena") {
+        MonotonicArena arena;
+        MonotonicArena::Scope scope{arena};
+        CHECK(MonotonicArena::installed_on_current_thread() == &arena);
+
+        using FA = FlexibleArrayChecked<StandardHeader, OverAlignedElement, ArenaAllocator>;
+        auto first = FA::with_header(3, StandardHeader{3});
+        auto second = FA::with_header(5, StandardHeader{5});
+
+        CHECK(reinterpret_cast<uintptr_t>(first.header()) % alignof(OverAlignedElement) == 0);
+        CHECK(reinterpret_cast<uintptr_t>(second.header()) % alignof(OverAlignedElement) == 0);
+        CHECK(reinterpret_cast<uintptr_t>(second.element_address(4)) % alignof(OverAlignedElement) == 0);
+        CHECK(arena.reserved_bytes() == MonotonicArena::default_initial_chunk_size);
+    }
+
+    TEST_CASE("Array growth extends the most recent arena block") {
+        MonotonicArena arena;
+        MonotonicArena::Scope scope{arena};
+
+        auto array = Array<Int, ArenaAllocator>::create_empty();
+        for (Int i = 0; i < 1000; ++i) {
+            array.append(i);
+        }
+        CHECK(array.count() == 1000);
+        CHECK(array[999] == 999);
+        // Every growth resized the last allocation in place, so the array fits into the first chunk.
+        CHECK(arena.reserved_bytes() == MonotonicArena::default_initial_chunk_size);
+    }
+
+    TEST_CASE("Scopes nest") {
+        MonotonicArena outer;
+        MonotonicArena inner;
+        {
+            MonotonicArena::Scope outer_scope{outer};
+            {
+                MonotonicArena::Scope inner_scope{inner};
+                CHECK(MonotonicArena::installed_on_current_thread() == &inner);
+            }
+            CHECK(MonotonicArena::installed_on_current_thread() == &outer);
+        }
+        CHECK(MonotonicArena::installed_on_current_thread() == nullptr);
+    }
+}
+
+TEST_SUITE("PoolAllocator") {
+    TEST_CASE("Requests are rounded up to aligned power-of-two classes") {
+        CHECK(PoolAllocator::size_class_for(1, 1) == 0);
+        CHECK(PoolAllocator::class_size(0) == 32);
+        CHECK(PoolAllocator::size_class_for(33, 8) == 1);
+        CHECK(PoolAllocator::size_class_for(8, 64) == 1);
+        CHECK(PoolAllocator::size_class_for(PoolAllocator::largest_class_size, 8) >= 0);
+        CHECK(PoolAllocator::size_class_for(PoolAllocator::largest_class_size + 1, 8) == -1);
+    }
+
+    TEST_CASE("Freed blocks are reused by the same thread") {
+        void* block = PoolAllocator::allocate(40, 8);
+        PoolAllocator::deallocate(block, 40, 8);
+        CHECK(PoolAllocator::allocate(40, 8) == block);
+        PoolAllocator::deallocate(block, 40, 8);
+    }
+
+    TEST_CASE("Small flexible arrays come from the pool, big ones from the heap") {
+        using FA = FlexibleArrayChecked<StandardHeader, OverAlignedElement, PoolAllocator>;
+        auto small = FA::with_header(3, StandardHeader{3});
+        auto big = FA::with_header(1000, StandardHeader{1000});
+
+        CHECK(reinterpret_cast<uintptr_t>(small.element_address(2)) % alignof(OverAlignedElement) == 0);
+        CHECK(reinterpret_cast<uintptr_t>(big.element_address(999)) % alignof(OverAlignedElement) == 0);
+    }
+
+    TEST_CASE("Arrays are created and destroyed concurrently") {
+        constexpr int kThreads = 8;
+        std::vector<std::thread> threads;
+        std::vector<Int> sums(kThreads);
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([t, &sums] {
+                for (int round = 0; round < 200; ++round) {
+                    auto array = Array<Int, PoolAllocator>::create_empty();
+                    for (Int i = 0; i < 60; ++i) {
+                        array.append(i);
+                    }
+                    sums[t] += array[59];
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (auto sum : sums) {
+            CHECK(sum == 200 * 59);
+        }
+    }
+
+    TEST_CASE("Blocks can be freed by another thread") {
+        using FA = FlexibleArrayChecked<StandardHeader, double, PoolAllocator>;
+        auto fa = FA::with_header(4, StandardHeader{4});
+        std::construct_at(fa.element_address(3), 2.5);
+
+        std::thread consumer([moved = std::move(fa)]() mutable {
+            CHECK(*moved.element_address(3) == 2.5);
+        });
+        consumer.join();
+    }
+
+    TEST_CASE("Thread-local arrays constructed before the first pool use free into the central lists") {
+        const void* freed_after_cache = nullptr;
+        std::thread([&freed_after_cache] {
+            // Constructed before the thread cache, so destroyed after it at thread exit.
+            thread_local auto array = Array<Int, PoolAllocator>::create_empty();
+            array.append(1);
+            freed_after_cache = array.storage_address();
+        }).join();
+
+        // The block freed last went to the central list, so the next thread to refill its cache gets it first.
+        const void* reused = nullptr;
+        std::thread([&reused] {
+            void* const block = PoolAllocator::allocate(64, 8);
+            reused = block;
+            PoolAllocator::deallocate(block, 64, 8);
+        }).join();
+        CHECK(reused == freed_after_cache);
+    }
+}
+
+TEST_SUITE("Allocation Tracking") {
+    TEST_CASE("Flexible arrays record their storage when tracking is enabled") {
+        AllocationTracking::reset();
+        {
+            using FA = FlexibleArrayChecked<StandardHeader, OverAlignedElement>;
+            auto first = FA::with_header(3, StandardHeader{3});
+            auto second = FA::with_header(3, StandardHeader{3});
+            auto third = FA::with_header(5, StandardHeader{5});
+
+            const auto statistics = AllocationTracking::statistics();
+            if constexpr (allocation_tracking_enabled) {
+                CHECK(statistics.allocation_count == 3);
+                // The 8 byte header is followed by 56 bytes of padding aligning the elements to 64.
+                CHECK(statistics.live_bytes == 2 * (64 + 3 * 64) + (64 + 5 * 64));
+                CHECK(statistics.peak_bytes == statistics.live_bytes);
+                CHECK(statistics.live_padding_bytes == 3 * 56);
+
+                const AllocationTracking::StorageShape shape{sizeof(StandardHeader), sizeof(OverAlignedElement), 3};
+                CHECK(statistics.allocations_per_shape.at(shape) == 2);
+                CHECK(statistics.allocations_per_shape.size() == 2);
+            } else {
+                CHECK(statistics.allocation_count == 0);
+            }
+        }
+
+        const auto statistics = AllocationTracking::statistics();
+        CHECK(statistics.live_bytes == 0);
+        CHECK(statistics.live_padding_bytes == 0);
+        CHECK(statistics.deallocation_count == statistics.allocation_count);
+    }
+
+    TEST_CASE("Reallocations and temporaries are recorded") {
+        AllocationTracking::reset();
+        {
+            auto array = Array<Int>::create_empty();
+            for (Int i = 0; i < 100; ++i) {
+                array.append(i);
+            }
+            FlexibleArrayUnchecked<StandardHeader, int>::project_temporary(4, [](auto&) { return 0; });
+
+            const auto statistics = AllocationTracking::statistics();
+            if constexpr (allocation_tracking_enabled) {
+                CHECK(statistics.allocation_count > 1);
+                CHECK(statistics.live_bytes >= 100 * static_cast<Int>(sizeof(Int)));
+                CHECK(statistics.temporary_count == 1);
+                CHECK(statistics.temporary_bytes > 0);
+            } else {
+                CHECK(statistics.temporary_count == 0);
+            }
+        }
+        CHECK(AllocationTracking::statistics().live_bytes == 0);
+    }
+}
+
+// A header of keys, values and one metadata byte per entry.
+struct ColumnsHeader {
+    Int entries;
+    Int metadata_bytes;
+
+    [[nodiscard]] std::array<Int, 3> trailing_element_counts() const { return {entries, entries, metadata_bytes}; }
+};
+
+TEST_SUITE("FlexibleArrayMulti") {
+    TEST_CASE("Trailing arrays are aligned and don't overlap") {
+        using FA = FlexibleArrayMulti<ColumnsHeader, char, OverAlignedElement, double>;
+        auto fa = FA::with_header(ColumnsHeader{3, 5});
+
+        CHECK(fa.count<0>() == 3);
+        CHECK(fa.count<1>() == 3);
+        CHECK(fa.count<2>() == 5);
+
+        const auto header = reinterpret_cast<uintptr_t>(fa.header());
+        const auto chars = reinterpret_cast<uintptr_t>(fa.elements_start<0>());
+        const auto over_aligned = reinterpret_cast<uintptr_t>(fa.elements_start<1>());
+        const auto doubles = reinterpret_cast<uintptr_t>(fa.elements_start<2>());
+
+        CHECK(header % alignof(OverAlignedElement) == 0);
+        CHECK(chars == header + sizeof(ColumnsHeader));
+        CHECK(over_aligned % alignof(OverAlignedElement) == 0);
+        CHECK(over_aligned >= chars + 3);
+        CHECK(doubles % alignof(double) == 0);
+        CHECK(doubles == over_aligned + 3 * sizeof(OverAlignedElement));
+    }
+
+    TEST_CASE("Columns are written and read independently") {
+        using FA = FlexibleArrayMulti<ColumnsHeader, Int, double, unsigned char>;
+        auto fa = FA::with_header(ColumnsHeader{100, 100});
+        for (Int i = 0; i < 100; ++i) {
+            std::construct_at(fa.element_address<0>(i), i);
+            std::construct_at(fa.element_address<1>(i), static_cast<double>(i) / 2);
+            std::construct_at(fa.element_address<2>(i), static_cast<unsigned char>(i));
+        }
+
+        Int key_sum = 0;
+        const Int* keys = std::as_const(fa).elements_start<0>();
+        for (Int i = 0; i < fa.count<0>(); ++i) {
+            key_sum += keys[i];
+        }
+        CHECK(key_sum == 4950);
+        CHECK(*fa.element_address<1>(99) == 49.5);
+        CHECK(*fa.element_address<2>(42) == 42);
+
+        auto moved = std::move(fa);
+        CHECK(!fa.is_valid());
+        CHECK(*moved.element_address<0>(7) == 7);
+    }
+
+    TEST_CASE("Empty trailing arrays") {
+        using FA = FlexibleArrayMulti<ColumnsHeader, Int, double, char>;
+        auto fa = FA::with_header(ColumnsHeader{0, 2});
+        CHECK(fa.count<0>() == 0);
+        CHECK(fa.elements_start<0>() == reinterpret_cast<Int*>(fa.elements_start<1>()));
+        std::construct_at(fa.element_address<2>(1), 'x');
+        CHECK(*fa.element_address<2>(1) == 'x');
+    }
+
+    TEST_CASE("Storage comes from the allocator policy") {
+        CountingAllocator::reset();
+        {
+            auto fa = AllocatedFlexibleArrayMulti<CountingAllocator, ColumnsHeader, Int, double, char>::with_header(
+                ColumnsHeader{4, 4});
+            CHECK(CountingAllocator::allocations == 1);
+            CHECK(CountingAllocator::live_bytes == sizeof(ColumnsHeader) + 4 * (8 + 8 + 1) + 4);
+        }
+        CHECK(CountingAllocator::deallocations == 1);
+        CHECK(CountingAllocator::live_bytes == 0);
+    }
+
+    TEST_CASE("The starts of all arrays are found with one layout") {
+        using FA = FlexibleArrayMulti<ColumnsHeader, char, OverAlignedElement, double>;
+        auto fa = FA::with_header(ColumnsHeader{3, 5});
+
+        const auto [chars, over_aligned, doubles] = fa.all_elements_start();
+        CHECK(chars == fa.elements_start<0>());
+        CHECK(over_aligned == fa.elements_start<1>());
+        CHECK(doubles == fa.elements_start<2>());
+
+        const auto const_starts = std::as_const(fa).all_elements_start();
+        static_assert(std::is_same_v<decltype(const_starts),
+                                     const std::tuple<const char*, const OverAlignedElement*, const double*>>);
+        CHECK(std::get<2>(const_starts) == doubles);
+    }
+
+    TEST_CASE("Storages are recorded when tracking is enabled") {
+        AllocationTracking::reset();
+        {
+            auto fa = FlexibleArrayMulti<ColumnsHeader, Int, double, char>::with_header(ColumnsHeader{4, 4});
+            const auto statistics = AllocationTracking::statistics();
+            if constexpr (allocation_tracking_enabled) {
+                CHECK(statistics.allocation_count == 1);
+                // 68 bytes of elements follow the 16 byte header, padded to a multiple of 8.
+                CHECK(statistics.live_bytes == 88);
+                CHECK(statistics.live_padding_bytes == 4);
+            } else {
+                CHECK(statistics.allocation_count == 0);
+            }
+        }
+        const auto statistics = AllocationTracking::statistics();
+        CHECK(statistics.live_bytes == 0);
+        CHECK(statistics.live_padding_bytes == 0);
+        CHECK(statistics.deallocation_count == statistics.allocation_count);
+    }
+}
+
+// A trade record of an analytics workload, with fields of differing sizes.
+struct Trade {
+    Int id;
+    double price;
+    int quantity;
+    char side;
+};
+
+TEST_SUITE("SoAArray") {
+    TEST_CASE("Fields of an aggregate are decomposed in declaration order") {
+        static_assert(Detail::aggregate_field_count<Trade>() == 4);
+        static_assert(std::is_same_v<Detail::FieldTypes<Trade>, std::tuple<Int, double, int, char>>);
+
+        Trade trade{1, 2.5, 3, 'b'};
+        auto fields = Detail::fields_of(trade);
+        std::get<1>(fields) = 4.5;
+        CHECK(trade.price == 4.5);
+        CHECK(std::get<3>(fields) == 'b');
+    }
+
+    TEST_CASE("Empty array holds no storage") {
+        auto trades = SoAArray<Trade>::create_empty();
+        CHECK(trades.empty());
+        CHECK(trades.count() == 0);
+        CHECK(trades.capacity() == 0);
+        CHECK(trades.column<&Trade::price>().empty());
+
+        trades.reserve(100);
+        CHECK(trades.empty());
+        CHECK(trades.capacity() == 100);
+        CHECK(trades.column<&Trade::price>().empty());
+
+        trades.append(Trade{1, 2.5, 3, 'b'});
+        CHECK(trades.capacity() == 100);
+        CHECK(trades[0].price == 2.5);
+    }
+
+    TEST_CASE("Array and reference fields are rejected") {
+        struct Samples {
+            int values[3];
+            char tag;
+        };
+        struct Borrowed {
+            int& value;
         };
+
+        // An array field counts as one field, so that the record decomposes without error.
+        static_assert(Detail::aggregate_field_count<Samples>() == 2);
+        static_assert(Detail::aggregate_field_count<Trade>() == 4);
+        static_assert(!Detail::is_initializable_from_field_values<Samples>);
+        static_assert(Detail::is_initializable_from_field_values<Trade>);
+        static_assert(!SoARecord<Borrowed>);
+    }
+
+    TEST_CASE("Records are gathered from the columns they were scattered to") {
+        auto trades = SoAArray<Trade>::create_empty();
+        for (Int i = 0; i < 1000; ++i) {
+            trades.append(Trade{i, static_cast<double>(i) / 4, static_cast<int>(i % 7), i % 2 == 0 ? 'b' : 's'});
+        }
+        CHECK(trades.count() == 1000);
+        CHECK(trades.capacity() >= 1000);
+
+        const Trade trade = trades[41];
+        CHECK(trade.id == 41);
+        CHECK(trade.price == 10.25);
+        CHECK(trade.quantity == 6);
+        CHECK(trade.side == 's');
+        CHECK(trades[998].price == 249.5);
+
+        trades.set(41, Trade{-1, 0.5, 2, 'x'});
+        CHECK(trades[41].id == -1);
+        CHECK(trades[41].side == 'x');
+        CHECK(trades[42].id == 42);
+    }
+
+    TEST_CASE("Columns are contiguous and scanned independently") {
+        auto trades = SoAArray<Trade>::create_empty();
+        for (Int i = 0; i < 100; ++i) {
+            trades.append(Trade{i, static_cast<double>(i), 1, 'b'});
+        }
+        trades.reserve(500);
+        CHECK(trades.capacity() == 500);
+
+        std::span<double> prices = trades.column<&Trade::price>();
+        REQUIRE(prices.size() == 100);
+        for (double& price : prices) {
+            price *= 2;
+        }
+
+        std::span<const Int> ids = std::as_const(trades).column<&Trade::id>();
+        Int id_sum = 0;
+        for (const Int id : ids) {
+            id_sum += id;
+        }
+        CHECK(id_sum == 4950);
+        CHECK(trades[10].price == 20.0);
+        CHECK(reinterpret_cast<uintptr_t>(prices.data()) % alignof(double) == 0);
+        CHECK(reinterpret_cast<const char*>(trades.column<&Trade::side>().data()) >=
+              reinterpret_cast<const char*>(trades.column<&Trade::quantity>().data() + trades.capacity()));
+
+        trades.field<&Trade::quantity>(3) = 9;
+        CHECK(trades[3].quantity == 9);
+        CHECK(std::as_const(trades).field<&Trade::side>(3) == 'b');
+    }
+}
+
+TEST_SUITE("Mixed Checked and Unchecked Usage") {
+    TEST_CASE("Convert checked to unchecked and back") {
+        using FAChecked = FlexibleArrayChecked<StandardHeader, int>;
+        using FAUnchecked = FlexibleArrayUnchecked<StandardHeader, int>;
         
-        using FA = FlexibleArrayChecked<ComplexHeader, double>;
+        auto checked = FAChecked::with_header(3, StandardHeader{3});
+        std::construct_at(checked.element_address(0), 42);
         
-        auto empty = FA::create_empty();
-        CHECK(!empty.is_valid());
+        // Extract to unchecked
+        auto unchecked = checked.extract_storage();
+        CHECK(*unchecked.element_address(0) == 42);
         
-        auto valid = FA::with_header(5, ComplexHeader{5, 999});
-        CHECK(valid.is_valid());
-        CHECK(valid.capacity() == 5);
-        CHECK(valid.header()->value == 999);
+        // Wrap back in checked (move into private constructor via factory)
+        auto checked2 = FAChecked::with_header_initialized_by(0, [&](StandardHeader* place) {
+            // The header must report the capacity, as destroying the storage releases that many elements.
+            std::construct_at(place, StandardHeader{0});
+        });
+        
+        // Since we can't directly construct from unchecked publicly, 
+        // verify the unchecked can still be used independently
+        CHECK(unchecked.header()->trailing_element_count() == 3);
+    }
+    
+    TEST_CASE("Checked wraps unchecked without overhead") {
+        using FAChecked = FlexibleArrayChecked<StandardHeader, int>;
+        using FAUnchecked = FlexibleArrayUnchecked<StandardHeader, int>;
+        
+        // Verify that FlexibleArrayChecked has the same size as FlexibleArrayUnchecked
+        // since it should only contain the unchecked storage member
+        CHECK(sizeof(FAChecked) == sizeof(FAUnchecked));
     }
 }
 
-TEST_SUITE("Alignment and Padding Verification") {
-    TEST_CASE("Misaligned header with over-aligned elements") {
-        struct TinyHeader {
-            char tag;
-            Int cap;
-            [[nodiscard]] Int trailing_element_count() const { return cap; }
-        };
+TEST_SUITE("is_valid() and create_empty() Comprehensive Tests") {
+    TEST_CASE("Empty array move assignment") {
+        using FA = FlexibleArrayChecked<StandardHeader, int>;
+        auto fa1 = FA::with_header(3, StandardHeader{3});
+        auto fa2 = FA::create_empty();
         
-        struct alignas(16) AlignedElement {
-            double value;
-        };
+        CHECK(fa1.is_valid());
+        CHECK(!fa2.is_valid());
         
-        using FA = FlexibleArrayChecked<TinyHeader, AlignedElement>;
-        auto fa = FA::with_header(5, TinyHeader{'X', 5});
+        fa1 = std::move(fa2);
+        CHECK(!fa1.is_valid());
+    }
+    
+    TEST_CASE("Move from empty to non-empty") {
+        using FA = FlexibleArrayChecked<StandardHeader, int>;
+        auto fa1 = FA::create_empty();
+        auto fa2 = FA::with_header(3, StandardHeader{3});
         
-        // Verify elements are properly aligned
-        auto elem_addr = reinterpret_cast<uintptr_t>(fa.element_address(0));
-        CHECK(elem_addr % 16 == 0);
+        CHECK(!fa1.is_valid());
+        CHECK(fa2.is_valid());
+        
+        fa1 = std::move(fa2);
+        CHECK(fa1.is_valid());
+        CHECK(!fa2.is_valid());
+        CHECK(fa1.capacity() == 3);
     }
     
-    TEST_CASE("Header larger than element alignment") {
-        struct alignas(64) LargeHeader {
-            char data[64];
-            Int cap;
-            explicit LargeHeader(Int c) : cap(c) { data[0] = 'H'; }
-            [[nodiscard]] Int trailing_element_count() const { return cap; }
-        };
+    TEST_CASE("Swap with empty array") {
+        using FA = FlexibleArrayChecked<StandardHeader, int>;
+        auto fa1 = FA::with_header(3, StandardHeader{3});
+        auto fa2 = FA::create_empty();
         
-        using FA = FlexibleArrayChecked<LargeHeader, char>;
-        auto fa = FA::with_header(10, LargeHeader{10});
+        CHECK(fa1.is_valid());
+        CHECK(!fa2.is_valid());
         
-        CHECK(fa.capacity() == 10);
-        auto header_addr = reinterpret_cast<uintptr_t>(fa.header());
-        CHECK(header_addr % 64 == 0);
+        swap(fa1, fa2);
+        
+        CHECK(!fa1.is_valid());
+        CHECK(fa2.is_valid());
+        CHECK(fa2.capacity() == 3);
+    }
+    
+    TEST_CASE("is_valid throughout lifecycle") {
+        using FA = FlexibleArrayChecked<StandardHeader, int>;
+        
+        // Create
+        auto fa = FA::with_header(5, StandardHeader{5});
+        CHECK(fa.is_valid());
+        
+        // Use
+        std::construct_at(fa.element_address(0), 42);
+        CHECK(fa.is_valid());
+        CHECK(*fa.element_address(0) == 42);
+        
+        // Move
+        auto fa2 = std::move(fa);
+        CHECK(!fa.is_valid());
+        CHECK(fa2.is_valid());
+        CHECK(*fa2.element_address(0) == 42);
+        
+        // Extract
+        auto unchecked = fa2.extract_storage();
+        CHECK(!fa2.is_valid());
+        CHECK(unchecked.is_valid());
+        CHECK(*unchecked.element_address(0) == 42);
+    }
+    
+    TEST_CASE("Unchecked empty array move assignment") {
+        using FA = FlexibleArrayUnchecked<StandardHeader, int>;
+        auto fa1 = FA::with_header(3, StandardHeader{3});
+        auto fa2 = FA::create_empty();
+        
+        CHECK(fa1.is_valid());
+        CHECK(!fa2.is_valid());
+        
+        fa1 = std::move(fa2);
+        CHECK(!fa1.is_valid());
+    }
+    
+    TEST_CASE("Unchecked swap with empty array") {
+        using FA = FlexibleArrayUnchecked<StandardHeader, int>;
+        auto fa1 = FA::with_header(3, StandardHeader{3});
+        auto fa2 = FA::create_empty();
+        
+        CHECK(fa1.is_valid());
+        CHECK(!fa2.is_valid());
+        
+        swap(fa1, fa2);
+        
+        CHECK(!fa1.is_valid());
+        CHECK(fa2.is_valid());
+        CHECK(fa2.header()->trailing_element_count() == 3);
+    }
+    
+    TEST_CASE("Multiple create_empty calls") {
+        using FA = FlexibleArrayChecked<StandardHeader, int>;
+        
+        auto fa1 = FA::create_empty();
+        auto fa2 = FA::create_empty();
+        auto fa3 = FA::create_empty();
+        
+        CHECK(!fa1.is_valid());
+        CHECK(!fa2.is_valid());
+        CHECK(!fa3.is_valid());
+        
+        // They should all be independently invalid
+        auto fa4 = std::move(fa1);
+        CHECK(!fa4.is_valid());
+    }
+    
+    TEST_CASE("Self-move of empty array") {
+        using FA = FlexibleArrayChecked<StandardHeader, int>;
+        auto fa = FA::create_empty();
+        
+        CHECK(!fa.is_valid());
+        
+        fa = std::move(fa);
+        CHECK(!fa.is_valid());
+    }
+    
+    TEST_CASE("Validity checks with different header types") {
+        struct ComplexHeader {
+            Int cap;
+            int value;
+            ComplexHeader(Int c, int v) : cap(c), value(v) {}
+            [[nodiscard]] Int trailing_element_count() const { return cap; }
+        };
+        
+        using FA = FlexibleArrayChecked<ComplexHeader, double>;
+        
+        auto empty = FA::create_empty();
+        CHECK(!empty.is_valid());
+        
+        auto valid = FA::with_header(5, ComplexHeader{5, 999});
+        CHECK(valid.is_valid());
+        CHECK(valid.capacity() == 5);
+        CHECK(valid.header()->value == 999);
+    }
+}
+
+TEST_SUITE("Alignment and Padding Verification") {
+    TEST_CASE("Misaligned header with over-aligned elements") {
+        struct TinyHeader {
+            char tag;
+            Int cap;
+            [[nodiscard]] Int trailing_element_count() const { return cap; }
+        };
+        
+        struct alignas(16) AlignedElement {
+            double value;
+        };
+        
+        using FA = FlexibleArrayChecked<TinyHeader, AlignedElement>;
+        auto fa = FA::with_header(5, TinyHeader{'X', 5});
+        
+        // Verify elements are properly aligned
+        auto elem_addr = reinterpret_cast<uintptr_t>(fa.element_address(0));
+        CHECK(elem_addr % 16 == 0);
+    }
+    
+    TEST_CASE("Header larger than element alignment") {
+        struct alignas(64) LargeHeader {
+            char data[64];
+            Int cap;
+            explicit LargeHeader(Int c) : cap(c) { data[0] = 'H'; }
+            [[nodiscard]] Int trailing_element_count() const { return cap; }
+        };
+        
+        using FA = FlexibleArrayChecked<LargeHeader, char>;
+        auto fa = FA::with_header(10, LargeHeader{10});
+        
+        CHECK(fa.capacity() == 10);
+        auto header_addr = reinterpret_cast<uintptr_t>(fa.header());
+        CHECK(header_addr % 64 == 0);
+    }
+}
+
+TEST_SUITE("Array Growth") {
+    TEST_CASE("Appending grows the capacity geometrically") {
+        auto array = Array<Int>::create_empty();
+        CHECK(array.capacity() == 0);
+
+        Int reallocations = 0;
+        Int last_capacity = array.capacity();
+        for (Int i = 0; i < 1000; ++i) {
+            array.append(i);
+            if (array.capacity() != last_capacity) {
+                reallocations++;
+                last_capacity = array.capacity();
+            }
+        }
+
+        CHECK(array.count() == 1000);
+        CHECK(array.capacity() >= 1000);
+        CHECK(reallocations <= 10);
+        for (Int i = 0; i < 1000; ++i) {
+            CHECK(array[i] == i);
+        }
+    }
+
+    TEST_CASE("Reserve never shrinks and keeps the elements") {
+        auto array = Array<double>::create_empty();
+        array.append(1.5);
+        array.append(2.5);
+
+        array.reserve(100);
+        CHECK(array.capacity() == 100);
+        CHECK(array.count() == 2);
+        CHECK(array[0] == 1.5);
+        CHECK(array[1] == 2.5);
+
+        array.reserve(10);
+        CHECK(array.capacity() == 100);
+    }
+
+    TEST_CASE("Non-trivially copyable elements are moved on growth") {
+        auto array = Array<std::string>::create_empty();
+        for (int i = 0; i < 100; ++i) {
+            array.append(std::string(32, static_cast<char>('a' + (i % 26))));
+        }
+
+        CHECK(array.count() == 100);
+        CHECK(array[0] == std::string(32, 'a'));
+        CHECK(array[99] == std::string(32, static_cast<char>('a' + (99 % 26))));
+    }
+
+    TEST_CASE("emplace_back of an element of the same array") {
+        auto array = Array<std::string>::create_with_capacity(1, std::string(64, 'x'));
+        CHECK(array.capacity() == 1);
+
+        // The argument refers into the storage that is replaced by the growth.
+        array.emplace_back(array[0]);
+        CHECK(array.count() == 2);
+        CHECK(array[1] == std::string(64, 'x'));
+    }
+
+    TEST_CASE("Elements are destroyed with the array") {
+        struct Tracked {
+            Tracked() { LifecycleTracker::constructed++; }
+            Tracked(Tracked&&) noexcept { LifecycleTracker::constructed++; }
+            Tracked& operator=(Tracked&&) noexcept { return *this; }
+            ~Tracked() { LifecycleTracker::destroyed++; }
+        };
+
+        LifecycleTracker::reset();
+        {
+            auto array = Array<Tracked>::create_empty();
+            for (int i = 0; i < 10; ++i) {
+                array.emplace_back();
+            }
+            auto moved = std::move(array);
+            CHECK(array.count() == 0);
+            CHECK(moved.count() == 10);
+        }
+        CHECK(LifecycleTracker::constructed == LifecycleTracker::destroyed);
+    }
+
+    TEST_CASE("A throwing first emplace_back leaves the array empty") {
+        struct Tracked {
+            explicit Tracked(const bool fail) {
+                if (fail) {
+                    throw std::runtime_error("construction failed");
+                }
+                LifecycleTracker::constructed++;
+            }
+            Tracked(Tracked&&) noexcept { LifecycleTracker::constructed++; }
+            Tracked& operator=(Tracked&&) noexcept { return *this; }
+            ~Tracked() { LifecycleTracker::destroyed++; }
+        };
+
+        CountingAllocator::reset();
+        LifecycleTracker::reset();
+        {
+            auto array = Array<Tracked, CountingAllocator>::create_empty();
+            bool caught = false;
+            try {
+                array.emplace_back(true);
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            CHECK(caught);
+            CHECK(array.empty());
+            CHECK(array.count() == 0);
+            CHECK(CountingAllocator::live_bytes == 0);
+
+            array.emplace_back(false);
+            CHECK(array.count() == 1);
+        }
+        CHECK(LifecycleTracker::destroyed == 1);
+        CHECK(CountingAllocator::allocations == CountingAllocator::deallocations);
+    }
+}
+
+TEST_SUITE("Array Empty Representation") {
+    TEST_CASE("Empty arrays hold no storage") {
+        static_assert(sizeof(Array<std::string>) == sizeof(void*));
+
+        CountingAllocator::reset();
+        auto array = Array<Int, CountingAllocator>::create_empty();
+        CHECK(array.empty());
+        CHECK(array.capacity() == 0);
+        CHECK(array.begin() == nullptr);
+        CHECK(array.begin() == array.end());
+        CHECK(CountingAllocator::allocations == 0);
+
+        auto hinted = Array<Int, CountingAllocator>::create_empty(16);
+        hinted.reserve(32);
+        CHECK(hinted.empty());
+        CHECK(hinted.storage_address() == nullptr);
+        CHECK(CountingAllocator::allocations == 0);
+
+        array.append(1);
+        CHECK(!array.empty());
+        CHECK(CountingAllocator::allocations == 1);
+    }
+
+    TEST_CASE("Removing every element leaves no storage behind") {
+        auto array = Array<std::string>::create_empty();
+        array.append("a");
+        array.clear();
+        CHECK(array.storage_address() == nullptr);
+
+        array.append("a");
+        array.erase(0);
+        CHECK(array.storage_address() == nullptr);
+
+        array.append("a");
+        array.pop_back();
+        CHECK(array.storage_address() == nullptr);
+
+        auto numbers = Array<Int>::create_empty();
+        numbers.append_uninitialized(8, [](std::span<Int>) { return 0; });
+        CHECK(numbers.storage_address() == nullptr);
+        numbers.append(1);
+        CHECK(numbers.storage_address() != nullptr);
+        numbers.resize_for_overwrite(0);
+        CHECK(numbers.storage_address() == nullptr);
+    }
+
+    TEST_CASE("create_with_capacity allocates together with the first element") {
+        CountingAllocator::reset();
+        {
+            auto array = Array<Int, CountingAllocator>::create_with_capacity(16, 7);
+            CHECK(array.count() == 1);
+            CHECK(array.capacity() == 16);
+            CHECK(array[0] == 7);
+            for (Int i = 1; i < 16; ++i) {
+                array.append(i);
+            }
+            CHECK(CountingAllocator::allocations == 1);
+        }
+        CHECK(CountingAllocator::allocations == CountingAllocator::deallocations);
+    }
+
+    TEST_CASE("Removing the last element frees the storage") {
+        CountingAllocator::reset();
+        auto array = Array<std::string, CountingAllocator>::create_empty();
+        array.append("a");
+        array.append("b");
+        array.append("c");
+
+        array.erase(1);
+        CHECK(array.count() == 2);
+        CHECK(array[0] == "a");
+        CHECK(array[1] == "c");
+
+        array.pop_back();
+        CHECK(array.count() == 1);
+        array.erase(0);
+        CHECK(array.empty());
+        CHECK(CountingAllocator::live_bytes == 0);
+
+        array.append("d");
+        array.append("e");
+        array.clear();
+        CHECK(array.empty());
+        CHECK(CountingAllocator::allocations == CountingAllocator::deallocations);
+    }
+
+    TEST_CASE("Clearing a shared array keeps the other copies") {
+        auto original = Array<Int>::create_empty();
+        original.append(1);
+        original.append(2);
+
+        auto copy = original;
+        copy.clear();
+        CHECK(copy.empty());
+        CHECK(original.count() == 2);
+        CHECK(original.is_uniquely_referenced());
+
+        copy = original;
+        copy.erase(0);
+        CHECK(std::as_const(copy)[0] == 2);
+        CHECK(std::as_const(original)[0] == 1);
+    }
+
+    TEST_CASE("Iterating over the elements") {
+        auto array = Array<Int>::create_empty();
+        for (Int i = 1; i <= 4; ++i) {
+            array.append(i);
+        }
+
+        const auto copy = array;
+        for (Int& element : array) {
+            element *= 10;
+        }
+
+        Int sum = 0;
+        for (const Int element : copy) {
+            sum += element;
+        }
+        CHECK(sum == 10);
+        CHECK(std::as_const(array)[3] == 40);
+    }
+}
+
+TEST_SUITE("Array Ranges") {
+    TEST_CASE("Arrays are contiguous ranges") {
+        static_assert(std::ranges::contiguous_range<Array<int>>);
+        static_assert(std::ranges::contiguous_range<const Array<int>>);
+
+        auto array = Array<int>::create_empty();
+        for (int value : {4, 8, 1, 6}) {
+            array.append(value);
+        }
+        std::ranges::sort(array);
+        CHECK(array[0] == 1);
+        CHECK(array[3] == 8);
+        CHECK(std::ranges::find(std::as_const(array), 6) == std::as_const(array).data() + 2);
+
+        std::vector<int> copy(4);
+        std::ranges::copy(std::as_const(array), copy.begin());
+        CHECK(copy == std::vector<int>{1, 4, 6, 8});
+    }
+
+    TEST_CASE("Span views of an empty array") {
+        const auto array = Array<double>::create_empty();
+        const std::span<const double> view = array;
+        CHECK(view.empty());
+        CHECK(array.data() == nullptr);
+    }
+
+    TEST_CASE("Mutable views unshare the storage") {
+        auto array = Array<int>::create_empty();
+        array.append(1);
+        array.append(2);
+        const auto copy = array;
+
+        const std::span<const int> shared = std::as_const(array);
+        CHECK(shared.data() == copy.data());
+
+        const std::span<int> view = array;
+        view[0] = 10;
+        CHECK(view.data() == array.data());
+        CHECK(view.data() != copy.data());
+        CHECK(copy[0] == 1);
+        CHECK(array[0] == 10);
+    }
+}
+
+// A character equal to the other case of itself, which its bytes don't tell.
+struct CaseInsensitiveChar {
+    char value;
+
+    friend bool operator==(const CaseInsensitiveChar a, const CaseInsensitiveChar b) noexcept {
+        const auto lower = [](const char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; };
+        return lower(a.value) == lower(b.value);
+    }
+};
+
+// A value whose comparisons may throw.
+struct ThrowingComparison {
+    int value;
+
+    friend bool operator==(const ThrowingComparison a, const ThrowingComparison b) {
+        if (a.value < 0 || b.value < 0) {
+            throw std::invalid_argument("negative value");
+        }
+        return a.value == b.value;
+    }
+};
+
+TEST_SUITE("Bulk Algorithms") {
+    TEST_CASE("Elements with their own operator== are compared with it") {
+        static_assert(std::is_trivially_copyable_v<CaseInsensitiveChar>);
+        static_assert(std::has_unique_object_representations_v<CaseInsensitiveChar>);
+        static_assert(!Detail::BytewiseComparable<CaseInsensitiveChar>);
+
+        std::vector<CaseInsensitiveChar> text;
+        for (const char c : std::string_view{"Hello, World! hello again"}) {
+            text.push_back(CaseInsensitiveChar{c});
+        }
+        std::vector<CaseInsensitiveChar> shouted;
+        for (const char c : std::string_view{"HELLO, WORLD! HELLO AGAIN"}) {
+            shouted.push_back(CaseInsensitiveChar{c});
+        }
+
+        CHECK(Bulk::find(text, CaseInsensitiveChar{'W'}) == 7);
+        CHECK(Bulk::find(text, CaseInsensitiveChar{'w'}) == 7);
+        CHECK(Bulk::count(text, CaseInsensitiveChar{'H'}) == 2);
+        CHECK(Bulk::count(text, CaseInsensitiveChar{'L'}) == 5);
+        CHECK(Bulk::equal(text, shouted));
+    }
+
+    TEST_CASE("Only scalar elements go to the kernels") {
+        enum class Color : uint8_t { red, green };
+        static_assert(Detail::BytewiseComparable<Int>);
+        static_assert(Detail::BytewiseComparable<bool>);
+        static_assert(Detail::BytewiseComparable<Color>);
+        static_assert(Detail::BytewiseComparable<const int*>);
+        static_assert(!Detail::BytewiseComparable<double>);
+        static_assert(!Detail::BytewiseComparable<std::pair<int, int>>);
+    }
+
+    TEST_CASE("Algorithms are noexcept unless the element operations they call may throw") {
+        const std::vector<Int> numbers{3, 1, 2};
+        static_assert(noexcept(Bulk::find(numbers, Int{1})));
+        static_assert(noexcept(Bulk::equal(numbers, numbers)));
+        static_assert(noexcept(Bulk::min(numbers)));
+        static_assert(noexcept(Bulk::count_if(numbers, [](const Int n) noexcept { return n > 1; })));
+        static_assert(!noexcept(Bulk::count_if(numbers, [](const Int n) { return n > 1; })));
+
+        std::vector<ThrowingComparison> values{{1}, {-1}, {2}};
+        static_assert(!noexcept(Bulk::find(values, ThrowingComparison{2})));
+        static_assert(!noexcept(Bulk::count(values, ThrowingComparison{2})));
+        static_assert(!noexcept(Bulk::equal(values, values)));
+
+        bool caught = false;
+        try {
+            (void)Bulk::count(values, ThrowingComparison{2});
+        } catch (const std::invalid_argument&) {
+            caught = true;
+        }
+        CHECK(caught);
+    }
+
+    TEST_CASE("find and count handle every element size and the tails after the last vector") {
+        for (Int count : {1, 7, 31, 64, 100}) {
+            std::vector<uint8_t> bytes(static_cast<size_t>(count), 1);
+            std::vector<int16_t> shorts(static_cast<size_t>(count), 1);
+            std::vector<int32_t> ints(static_cast<size_t>(count), 1);
+            std::vector<Int> longs(static_cast<size_t>(count), 1);
+            CHECK(Bulk::find(bytes, uint8_t{2}) == count);
+            CHECK(Bulk::count(longs, Int{1}) == count);
+
+            const auto last = static_cast<size_t>(count - 1);
+            bytes[last] = 2;
+            shorts[last] = -2;
+            ints[last] = -2;
+            longs[last] = -2;
+            CHECK(Bulk::find(bytes, uint8_t{2}) == count - 1);
+            CHECK(Bulk::find(shorts, int16_t{-2}) == count - 1);
+            CHECK(Bulk::find(ints, -2) == count - 1);
+            CHECK(Bulk::find(longs, Int{-2}) == count - 1);
+            CHECK(Bulk::count(bytes, uint8_t{1}) == count - 1);
+            CHECK(Bulk::count(shorts, int16_t{1}) == count - 1);
+            CHECK(Bulk::count(ints, 1) == count - 1);
+            CHECK(Bulk::count(longs, Int{-2}) == 1);
+        }
+    }
+
+    TEST_CASE("find returns the first match") {
+        std::vector<Int> values(100);
+        std::iota(values.begin(), values.end(), 0);
+        values[70] = 5;
+        CHECK(Bulk::find(values, Int{5}) == 5);
+        CHECK(Bulk::find(std::span{values}.subspan(6), Int{5}) == 64);
+        CHECK(Bulk::find(std::span<const Int>{}, Int{5}) == 0);
+    }
+
+    TEST_CASE("fill stores the value in every element") {
+        for (Int count : {0, 3, 33, 100}) {
+            std::vector<int16_t> shorts(static_cast<size_t>(count));
+            Bulk::fill(shorts, int16_t{-3});
+            CHECK(Bulk::count(shorts, int16_t{-3}) == count);
+
+            std::vector<double> doubles(static_cast<size_t>(count));
+            Bulk::fill(doubles, 0.5);
+            CHECK(std::ranges::all_of(doubles, [](double value) { return value == 0.5; }));
+        }
+    }
+
+    TEST_CASE("equal compares counts and elements") {
+        std::vector<Int> a(50, 7);
+        std::vector<Int> b(50, 7);
+        CHECK(Bulk::equal(a, b));
+        b[49] = 8;
+        CHECK(!Bulk::equal(a, b));
+        b.pop_back();
+        CHECK(!Bulk::equal(a, b));
+        CHECK(Bulk::equal(std::span<const Int>{}, std::span<const Int>{}));
+
+        // Equal floating-point values may have different bytes.
+        const std::vector<double> zero{0.0};
+        const std::vector<double> negative_zero{-0.0};
+        CHECK(Bulk::equal(zero, negative_zero));
+    }
+
+    TEST_CASE("count_if counts the matching elements") {
+        std::vector<Int> values(37);
+        std::iota(values.begin(), values.end(), 0);
+        CHECK(Bulk::count_if(values, [](Int value) { return value % 3 == 0; }) == 13);
+        CHECK(Bulk::count_if(std::span<const Int>{}, [](Int) { return true; }) == 0);
+    }
+
+    TEST_CASE("min and max of signed integers, and of other types") {
+        for (Int count : {1, 5, 17, 64, 99}) {
+            std::vector<int32_t> ints(static_cast<size_t>(count));
+            std::vector<Int> longs(static_cast<size_t>(count));
+            std::iota(ints.begin(), ints.end(), -10);
+            std::iota(longs.begin(), longs.end(), -10);
+            std::ranges::reverse(longs);
+            CHECK(Bulk::min(ints) == -10);
+            CHECK(Bulk::max(ints) == -10 + count - 1);
+            CHECK(Bulk::min(longs) == -10);
+            CHECK(Bulk::max(longs) == -10 + count - 1);
+        }
+        const std::vector<Int> extremes{0, std::numeric_limits<Int>::min(), 3, std::numeric_limits<Int>::max(), 1};
+        CHECK(Bulk::min(extremes) == std::numeric_limits<Int>::min());
+        CHECK(Bulk::max(extremes) == std::numeric_limits<Int>::max());
+
+        const std::vector<double> doubles{2.5, -1.0, 4.0};
+        CHECK(Bulk::min(doubles) == -1.0);
+        CHECK(Bulk::max(doubles) == 4.0);
+    }
+
+    TEST_CASE("Queries on a shared array do not copy it") {
+        auto array = Array<Int>::create_empty();
+        for (Int i = 0; i < 20; ++i) {
+            array.append(i);
+        }
+        const auto copy = array;
+        CHECK(Bulk::find(array, Int{12}) == 12);
+        CHECK(Bulk::count(array, Int{3}) == 1);
+        CHECK(Bulk::max(array) == 19);
+        CHECK(Bulk::equal(array, copy));
+        CHECK(std::as_const(array).data() == copy.data());
+    }
+
+    TEST_CASE("Array::fill unshares the storage") {
+        auto array = Array<Int>::create_empty();
+        for (Int i = 0; i < 10; ++i) {
+            array.append(i);
+        }
+        const auto copy = array;
+        array.fill(4);
+        CHECK(Bulk::count(array, Int{4}) == 10);
+        CHECK(copy[9] == 9);
+
+        auto strings = Array<std::string>::create_empty();
+        strings.append("a");
+        strings.append("b");
+        strings.fill("c");
+        CHECK(strings[0] == "c");
+        CHECK(strings[1] == "c");
+    }
+
+    TEST_CASE("Array::assign_from reuses unshared storage") {
+        auto array = Array<Int>::create_empty();
+        for (Int i = 0; i < 10; ++i) {
+            array.append(i);
+        }
+        const Int* const storage = array.data();
+        const std::vector<Int> source{7, 8, 9};
+        array.assign_from(source);
+        CHECK(array.count() == 3);
+        CHECK(array.data() == storage);
+        CHECK(Bulk::equal(array, source));
+
+        // Assigning from its own elements.
+        array.assign_from(std::span<const Int>{std::as_const(array).data() + 1, 2});
+        CHECK(array.count() == 2);
+        CHECK(array[0] == 8);
+        CHECK(array[1] == 9);
+
+        array.assign_from({});
+        CHECK(array.empty());
+    }
+
+    TEST_CASE("Array::assign_from leaves shared storage to its other owners") {
+        auto array = Array<std::string>::create_empty();
+        array.append("a");
+        const auto copy = array;
+        const std::vector<std::string> source{"x", "y", "z"};
+        array.assign_from(source);
+        CHECK(array.count() == 3);
+        CHECK(array.capacity() == 3);
+        CHECK(array[2] == "z");
+        CHECK(copy.count() == 1);
+        CHECK(copy[0] == "a");
+
+        auto shared_ints = Array<Int>::create_empty();
+        shared_ints.append(1);
+        shared_ints.append(2);
+        const auto ints_copy = shared_ints;
+        shared_ints.assign_from(std::span<const Int>{std::as_const(shared_ints).data(), 1});
+        CHECK(shared_ints.count() == 1);
+        CHECK(shared_ints[0] == 1);
+        CHECK(ints_copy.count() == 2);
+    }
+}
+
+TEST_SUITE("SIMD Kernel Dispatch") {
+    TEST_CASE("Instruction sets are found by the names of their kernels") {
+        for (auto instruction_set : SimdKernels::all_instruction_sets) {
+            if (const auto* kernels = SimdKernels::kernels_for(instruction_set)) {
+                CHECK(SimdKernels::instruction_set_named(kernels->name) == instruction_set);
+            }
+        }
+        CHECK(SimdKernels::instruction_set_named("avx1024") == std::nullopt);
+        CHECK(SimdKernels::is_supported(SimdKernels::InstructionSet::scalar));
+        CHECK(SimdKernels::is_supported(SimdKernels::best_supported()));
+    }
+
+    TEST_CASE("The active kernels are the best supported unless forced") {
+        const auto& active = SimdKernels::active();
+        CHECK(&active == &SimdKernels::active());
+        if (const char* forced = std::getenv(SimdKernels::force_instruction_set_variable)) {
+            CHECK(std::string_view{active.name} == forced);
+        } else {
+            CHECK(&active == SimdKernels::kernels_for(SimdKernels::best_supported()));
+        }
+    }
+
+    TEST_CASE("Every supported instruction set agrees with the scalar kernels") {
+        const auto& scalar = SimdKernels::scalar_kernels;
+        std::mt19937_64 random{42};
+        for (auto instruction_set : SimdKernels::all_instruction_sets) {
+            if (!SimdKernels::is_supported(instruction_set)) {
+                continue;
+            }
+            const auto& kernels = *SimdKernels::kernels_for(instruction_set);
+            INFO(kernels.name);
+            for (Int count = 1; count < 150; count += 7) {
+                // Few distinct byte values make matches frequent; the odd offset makes the loads unaligned.
+                std::vector<std::byte> buffer(static_cast<size_t>(count) * 8 + 9);
+                for (auto& byte : buffer) {
+                    byte = static_cast<std::byte>(random() % 3);
+                }
+                const std::byte* elements = buffer.data() + 1;
+                for (size_t index = 0; index < 4; ++index) {
+                    const uint64_t value = random() % 3;
+                    CHECK(kernels.find[index](elements, count, value) == scalar.find[index](elements, count, value));
+                    CHECK(kernels.count[index](elements, count, value) == scalar.count[index](elements, count, value));
+
+                    const size_t size = size_t{1} << index;
+                    std::vector<std::byte> filled(static_cast<size_t>(count) * size);
+                    std::vector<std::byte> expected(filled.size());
+                    kernels.fill[index](filled.data(), count, value | 0x80);
+                    scalar.fill[index](expected.data(), count, value | 0x80);
+                    CHECK(filled == expected);
+
+                    const size_t bytes = static_cast<size_t>(count) * size;
+                    CHECK(kernels.equal(elements, elements + 8, bytes) == scalar.equal(elements, elements + 8, bytes));
+                    CHECK(kernels.equal(elements, elements, bytes));
+                }
+
+                std::vector<int32_t> ints(static_cast<size_t>(count));
+                std::vector<Int> longs(static_cast<size_t>(count));
+                for (size_t i = 0; i < ints.size(); ++i) {
+                    ints[i] = static_cast<int32_t>(random());
+                    longs[i] = static_cast<Int>(random());
+                }
+                const auto min_max = [count](auto kernel, const auto& values) {
+                    using Value = std::ranges::range_value_t<decltype(values)>;
+                    std::pair<Value, Value> result;
+                    kernel(reinterpret_cast<const std::byte*>(values.data()), count,
+                           reinterpret_cast<std::byte*>(&result.first), reinterpret_cast<std::byte*>(&result.second));
+                    return result;
+                };
+                CHECK(min_max(kernels.min_max_i32, ints) == min_max(scalar.min_max_i32, ints));
+                CHECK(min_max(kernels.min_max_i64, longs) == min_max(scalar.min_max_i64, longs));
+            }
+        }
+    }
+}
+
+TEST_SUITE("Array Uninitialized Construction") {
+    TEST_CASE("append_uninitialized appends what the writer wrote") {
+        auto array = Array<char>::create_empty();
+        const std::string_view input = "hello, world";
+        const Int appended = array.append_uninitialized(64, [&](std::span<char> destination) {
+            std::memcpy(destination.data(), input.data(), input.size());
+            return input.size();
+        });
+        CHECK(appended == 12);
+        CHECK(array.count() == 12);
+        CHECK(array.capacity() >= 64);
+        CHECK(std::string_view{std::as_const(array).data(), 12} == input);
+
+        array.append_uninitialized(3, [](std::span<char> destination) { std::ranges::fill(destination, '!'); });
+        CHECK(array.count() == 15);
+        CHECK(array[14] == '!');
+    }
+
+    TEST_CASE("An empty array stays without storage when nothing is written") {
+        auto array = Array<Int>::create_empty();
+        CHECK(array.append_uninitialized(10, [](std::span<Int>) { return 0; }) == 0);
+        CHECK(array.empty());
+        CHECK(array.capacity() == 0);
+        CHECK(array.append_uninitialized(0, [](std::span<Int>) { return 0; }) == 0);
+        CHECK(array.empty());
+
+    }
+
+    TEST_CASE("A throwing writer leaves the array as it was") {
+        CountingAllocator::reset();
+        {
+            auto array = Array<Int, CountingAllocator>::create_empty();
+            const auto throwing_writer = [](std::span<Int> destination) -> Int {
+                destination[0] = 1;
+                throw std::runtime_error("read failed");
+            };
+            bool caught = false;
+            try {
+                array.append_uninitialized(8, throwing_writer);
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            CHECK(caught);
+            CHECK(array.empty());
+            CHECK(array.capacity() == 0);
+            CHECK(CountingAllocator::live_bytes == 0);
+
+            array.append(7);
+            caught = false;
+            try {
+                array.append_uninitialized(8, throwing_writer);
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            CHECK(caught);
+            CHECK(array.count() == 1);
+            CHECK(array[0] == 7);
+        }
+        CHECK(CountingAllocator::allocations == CountingAllocator::deallocations);
+    }
+
+    TEST_CASE("append_uninitialized grows geometrically and unshares") {
+        auto array = Array<Int>::create_empty();
+        array.append(1);
+        const auto copy = array;
+        for (Int chunk = 0; chunk < 10; ++chunk) {
+            array.append_uninitialized(5, [&](std::span<Int> destination) {
+                std::iota(destination.begin(), destination.end(), 10 * chunk);
+            });
+        }
+        CHECK(array.count() == 51);
+        CHECK(array[1] == 0);
+        CHECK(array[50] == 94);
+        CHECK(array.capacity() < 2 * 51 + 5);
+        CHECK(copy.count() == 1);
+    }
+
+    TEST_CASE("resize_for_overwrite leaves trivial elements for the caller") {
+        auto array = Array<Int>::create_empty();
+        array.resize_for_overwrite(100);
+        CHECK(array.count() == 100);
+        std::iota(array.begin(), array.end(), 0);
+        CHECK(array[99] == 99);
+
+        array.resize_for_overwrite(10);
+        CHECK(array.count() == 10);
+        CHECK(array[9] == 9);
+
+        array.resize_for_overwrite(0);
+        CHECK(array.empty());
+    }
+
+    TEST_CASE("resize_for_overwrite default-initializes and destroys other elements") {
+        struct Tracked {
+            Tracked() { LifecycleTracker::constructed++; }
+            Tracked(Tracked&&) noexcept { LifecycleTracker::constructed++; }
+            Tracked& operator=(Tracked&&) noexcept { return *this; }
+            ~Tracked() { LifecycleTracker::destroyed++; }
+        };
+
+        LifecycleTracker::reset();
+        {
+            auto array = Array<Tracked>::create_empty();
+            array.resize_for_overwrite(4);
+            CHECK(LifecycleTracker::constructed == 4);
+            array.resize_for_overwrite(1);
+            CHECK(LifecycleTracker::destroyed == 3);
+        }
+        CHECK(LifecycleTracker::constructed == LifecycleTracker::destroyed);
+
+        auto strings = Array<std::string>::create_empty();
+        strings.append("a");
+        const auto copy = strings;
+        strings.resize_for_overwrite(3);
+        CHECK(strings[0] == "a");
+        CHECK(strings[2].empty());
+        CHECK(copy.count() == 1);
+    }
+
+    TEST_CASE("resize_for_overwrite keeps the elements if default-initializing one throws") {
+        struct FallibleDefault {
+            FallibleDefault() {
+                if (LifecycleTracker::constructed == 2) {
+                    throw std::runtime_error("default");
+                }
+                LifecycleTracker::constructed++;
+            }
+            FallibleDefault(FallibleDefault&&) noexcept { LifecycleTracker::constructed++; }
+            FallibleDefault& operator=(FallibleDefault&&) noexcept { return *this; }
+            ~FallibleDefault() { LifecycleTracker::destroyed++; }
+        };
+        static_assert(noexcept(std::declval<Array<Int>&>().resize_for_overwrite(1)));
+        static_assert(!noexcept(std::declval<Array<FallibleDefault>&>().resize_for_overwrite(1)));
+
+        LifecycleTracker::reset();
+        auto array = Array<FallibleDefault>::create_empty();
+        bool caught = false;
+        try {
+            array.resize_for_overwrite(4);
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(array.storage_address() == nullptr);
+        CHECK(LifecycleTracker::constructed == LifecycleTracker::destroyed);
+
+        LifecycleTracker::reset();
+        array.resize_for_overwrite(1);
+        caught = false;
+        try {
+            array.resize_for_overwrite(4);
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(array.count() == 1);
+        CHECK(LifecycleTracker::constructed - LifecycleTracker::destroyed == 1);
+    }
+}
+
+/// A handle whose moves are counted, and which opts in to relocation by memmove.
+struct RelocatableHandle {
+    static inline int moves = 0;
+    int* value;
+
+    explicit RelocatableHandle(int* value) : value(value) {}
+    RelocatableHandle(RelocatableHandle&& other) noexcept : value(std::exchange(other.value, nullptr)) { ++moves; }
+    RelocatableHandle& operator=(RelocatableHandle&& other) noexcept {
+        value = std::exchange(other.value, nullptr);
+        ++moves;
+        return *this;
+    }
+    ~RelocatableHandle() = default;
+};
+
+template <>
+struct is_trivially_relocatable<RelocatableHandle> : std::true_type {};
+
+TEST_SUITE("Array Relocation") {
+    TEST_CASE("Trivially relocatable types") {
+        static_assert(is_trivially_relocatable_v<int>);
+        static_assert(is_trivially_relocatable_v<const Int>);
+        static_assert(is_trivially_relocatable_v<std::unique_ptr<int>>);
+        static_assert(is_trivially_relocatable_v<std::unique_ptr<int[]>>);
+        static_assert(is_trivially_relocatable_v<Array<std::string>>);
+        static_assert(is_trivially_relocatable_v<RelocatableHandle>);
+        static_assert(!is_trivially_relocatable_v<std::string>);
+        static_assert(!is_trivially_relocatable_v<std::unique_ptr<int, std::function<void(int*)>>>);
+    }
+
+    TEST_CASE("Inserting and erasing move-only handles") {
+        auto array = Array<std::unique_ptr<int>>::create_empty();
+        for (int i = 0; i < 10; ++i) {
+            array.append(std::make_unique<int>(i));
+        }
+        array.insert(5, std::make_unique<int>(100));
+        array.insert(0, std::make_unique<int>(200));
+        array.insert(array.count(), std::make_unique<int>(300));
+        CHECK(array.count() == 13);
+        CHECK(*array[0] == 200);
+        CHECK(*array[1] == 0);
+        CHECK(*array[6] == 100);
+        CHECK(*array[7] == 5);
+        CHECK(*array[12] == 300);
+
+        array.erase(6);
+        array.erase(0);
+        CHECK(array.count() == 11);
+        for (int i = 0; i < 10; ++i) {
+            CHECK(*array[i] == i);
+        }
+        CHECK(*array[10] == 300);
+    }
+
+    TEST_CASE("Opted-in types move with memmove") {
+        int values[64];
+        auto array = Array<RelocatableHandle>::create_empty();
+        for (int& value : values) {
+            array.emplace_back(&value);
+        }
+        RelocatableHandle::moves = 0;
+        array.emplace(32, &values[0]);
+        array.erase(10);
+        // Only the temporary of the new element is moved, even though the storage grew.
+        CHECK(RelocatableHandle::moves == 1);
+        CHECK(array.count() == 64);
+        CHECK(array[31].value == &values[0]);
+        CHECK(array[10].value == &values[11]);
+        CHECK(array[63].value == &values[63]);
+    }
+
+    TEST_CASE("Inserting other elements moves them one by one") {
+        auto array = Array<std::string>::create_empty();
+        for (const char* text : {"a", "b", "c"}) {
+            array.append(text);
+        }
+        array.insert(1, std::string(32, 'x'));
+        array.insert(0, array[3]);
+        CHECK(array.count() == 5);
+        CHECK(array[0] == "c");
+        CHECK(array[1] == "a");
+        CHECK(array[2] == std::string(32, 'x'));
+        CHECK(array[4] == "c");
+
+        const auto copy = array;
+        array.insert(2, "y");
+        CHECK(array[2] == "y");
+        CHECK(copy.count() == 5);
+        CHECK(copy[2] == std::string(32, 'x'));
+    }
+
+    TEST_CASE("Arrays of arrays grow by relocation") {
+        auto arrays = Array<Array<int>>::create_empty();
+        for (int i = 0; i < 20; ++i) {
+            auto inner = Array<int>::create_empty();
+            inner.append(i);
+            arrays.insert(0, std::move(inner));
+        }
+        CHECK(arrays.count() == 20);
+        CHECK(arrays[0][0] == 19);
+        CHECK(arrays[19][0] == 0);
+        arrays.erase(0);
+        CHECK(arrays[0][0] == 18);
+    }
+}
+
+// A tracked element whose copy throws once `copies_left` copies were made, and whose move constructor may throw.
+struct FallibleCopy {
+    static inline int copies_left = 0;
+    Int value;
+
+    explicit FallibleCopy(const Int value) : value(value) { LifecycleTracker::constructed++; }
+    FallibleCopy(const FallibleCopy& other) : value(other.value) {
+        if (copies_left == 0) {
+            throw std::runtime_error("copy");
+        }
+        copies_left--;
+        LifecycleTracker::constructed++;
+    }
+    FallibleCopy(FallibleCopy&& other) : value(other.value) { LifecycleTracker::constructed++; }
+    FallibleCopy& operator=(const FallibleCopy&) = default;
+    FallibleCopy& operator=(FallibleCopy&&) = default;
+    ~FallibleCopy() { LifecycleTracker::destroyed++; }
+};
+
+TEST_SUITE("Array Copy-on-Write") {
+    TEST_CASE("Copies share the storage") {
+        auto original = Array<Int>::create_empty();
+        for (Int i = 0; i < 10; ++i) {
+            original.append(i);
+        }
+
+        const auto copy = original;
+        CHECK(!original.is_uniquely_referenced());
+        CHECK(!copy.is_uniquely_referenced());
+        CHECK(&std::as_const(original)[0] == &copy[0]);
+        CHECK(copy.count() == 10);
+    }
+
+    TEST_CASE("The first mutation of a shared array copies the elements") {
+        auto original = Array<std::string>::create_empty();
+        original.append("a");
+        original.append("b");
+
+        auto copy = original;
+        copy[0] = "changed";
+
+        CHECK(original.is_uniquely_referenced());
+        CHECK(copy.is_uniquely_referenced());
+        CHECK(std::as_const(original)[0] == "a");
+        CHECK(std::as_const(copy)[0] == "changed");
+        CHECK(std::as_const(copy)[1] == "b");
+    }
+
+    TEST_CASE("Appending to a shared array leaves the other copies untouched") {
+        auto original = Array<Int>::create_empty(2);
+        original.append(1);
+        original.append(2);
+
+        auto copy = original;
+        copy.append(3);
+
+        CHECK(original.count() == 2);
+        CHECK(copy.count() == 3);
+        CHECK(std::as_const(copy)[2] == 3);
+
+        // Appending an element of the shared storage itself.
+        auto other = original;
+        other.emplace_back(std::as_const(original)[1]);
+        CHECK(std::as_const(other)[2] == 2);
+    }
+
+    TEST_CASE("Copies made after handing out a mutable reference do not see writes through it") {
+        auto original = Array<Int>::create_empty();
+        original.append(1);
+        original.append(2);
+
+        Int& element = original[0];
+        const auto copy = original;
+        element = 10;
+        CHECK(copy[0] == 1);
+        CHECK(std::as_const(original)[0] == 10);
+        CHECK(original.is_uniquely_referenced());
+        CHECK(copy.is_uniquely_referenced());
+
+        const std::span<Int> view = original;
+        auto assigned = Array<Int>::create_empty();
+        assigned = original;
+        view[1] = 20;
+        CHECK(assigned[1] == 2);
+
+        // Reading through a const array keeps the storage shareable.
+        auto untouched = Array<Int>::create_empty();
+        untouched.append(1);
+        CHECK(std::as_const(untouched)[0] == 1);
+        const auto shared = untouched;
+        CHECK(!untouched.is_uniquely_referenced());
+    }
+
+    TEST_CASE("Copying operations are noexcept only for elements that copy without throwing") {
+        static_assert(noexcept(std::declval<Array<Int>&>()[0]));
+        static_assert(std::is_nothrow_copy_constructible_v<Array<Int>>);
+        static_assert(!noexcept(std::declval<Array<FallibleCopy>&>()[0]));
+        static_assert(!noexcept(std::declval<Array<FallibleCopy>&>().reserve(8)));
+        static_assert(!std::is_nothrow_copy_constructible_v<Array<FallibleCopy>>);
+        static_assert(!std::is_nothrow_copy_assignable_v<Array<FallibleCopy>>);
+    }
+
+    TEST_CASE("A throwing copy while unsharing leaves the storage shared") {
+        LifecycleTracker::reset();
+        {
+            auto original = Array<FallibleCopy>::create_empty();
+            for (Int i = 0; i < 3; ++i) {
+                original.emplace_back(i);
+            }
+            auto copy = original;
+
+            FallibleCopy::copies_left = 1;
+            bool caught = false;
+            try {
+                (void)copy[0];
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            CHECK(caught);
+            CHECK(!copy.is_uniquely_referenced());
+            CHECK(LifecycleTracker::constructed - LifecycleTracker::destroyed == 3);
+            CHECK(std::as_const(copy)[2].value == 2);
+        }
+        CHECK(LifecycleTracker::constructed == LifecycleTracker::destroyed);
+    }
+
+    TEST_CASE("Growth copies elements whose move may throw, keeping them if a copy throws") {
+        LifecycleTracker::reset();
+        {
+            auto array = Array<FallibleCopy>::create_empty();
+            for (Int i = 0; i < 4; ++i) {
+                array.emplace_back(i);
+            }
+            REQUIRE(array.count() == array.capacity());
+
+            FallibleCopy::copies_left = 2;
+            bool caught = false;
+            try {
+                array.emplace_back(4);
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            CHECK(caught);
+            CHECK(array.count() == 4);
+            CHECK(std::as_const(array)[3].value == 3);
+            CHECK(LifecycleTracker::constructed - LifecycleTracker::destroyed == 4);
+
+            FallibleCopy::copies_left = 4;
+            array.emplace_back(4);
+            CHECK(array.count() == 5);
+            CHECK(std::as_const(array)[4].value == 4);
+        }
+        CHECK(LifecycleTracker::constructed == LifecycleTracker::destroyed);
+    }
+
+    TEST_CASE("Array::assign_from keeps the elements if a copy throws") {
+        static_assert(noexcept(std::declval<Array<Int>&>().assign_from({})));
+        static_assert(!noexcept(std::declval<Array<FallibleCopy>&>().assign_from({})));
+
+        LifecycleTracker::reset();
+        {
+            auto array = Array<FallibleCopy>::create_empty();
+            array.emplace_back(1);
+            auto source = Array<FallibleCopy>::create_empty();
+            for (Int i = 0; i < 3; ++i) {
+                source.emplace_back(i);
+            }
+
+            FallibleCopy::copies_left = 2;
+            bool caught = false;
+            try {
+                array.assign_from(source);
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            CHECK(caught);
+            CHECK(array.count() == 1);
+            CHECK(std::as_const(array)[0].value == 1);
+            CHECK(LifecycleTracker::constructed - LifecycleTracker::destroyed == 4);
+        }
+        CHECK(LifecycleTracker::constructed == LifecycleTracker::destroyed);
+    }
+
+    TEST_CASE("Elements are destroyed with the last reference") {
+        struct Tracked {
+            Tracked() { LifecycleTracker::constructed++; }
+            Tracked(const Tracked&) { LifecycleTracker::constructed++; }
+            Tracked(Tracked&&) noexcept { LifecycleTracker::constructed++; }
+            Tracked& operator=(const Tracked&) = default;
+            Tracked& operator=(Tracked&&) noexcept = default;
+            ~Tracked() { LifecycleTracker::destroyed++; }
+        };
+
+        LifecycleTracker::reset();
+        {
+            auto original = Array<Tracked>::create_empty();
+            original.emplace_back();
+            original.emplace_back();
+            {
+                auto copy = original;
+                auto another = copy;
+                CHECK(LifecycleTracker::destroyed == 0);
+            }
+            CHECK(LifecycleTracker::destroyed == 0);
+            CHECK(original.is_uniquely_referenced());
+        }
+        CHECK(LifecycleTracker::constructed == LifecycleTracker::destroyed);
+    }
+
+    TEST_CASE("Copy assignment") {
+        auto first = Array<Int>::create_empty();
+        first.append(1);
+        auto second = Array<Int>::create_empty();
+        second.append(2);
+
+        second = first;
+        CHECK(std::as_const(second)[0] == 1);
+        CHECK(!first.is_uniquely_referenced());
+
+        second = second;
+        CHECK(std::as_const(second)[0] == 1);
+
+        auto empty = Array<Int>::create_empty();
+        first = empty;
+        CHECK(first.count() == 0);
+        CHECK(second.is_uniquely_referenced());
+    }
+
+    TEST_CASE("Move-only elements make the array move-only") {
+        static_assert(std::is_copy_constructible_v<Array<Int>>);
+        static_assert(!std::is_copy_constructible_v<Array<std::unique_ptr<Int>>>);
+
+        auto array = Array<std::unique_ptr<Int>>::create_empty();
+        array.append(std::make_unique<Int>(5));
+        CHECK(*array[0] == 5);
+    }
+}
+
+TEST_SUITE("Reference Counters") {
+    TEST_CASE_TEMPLATE("Counting a single thread's references", Counter,
+                       NonAtomicReferenceCounter, AtomicReferenceCounter, BiasedReferenceCounter) {
+        Counter counter;
+        CHECK(counter.is_unique());
+
+        counter.retain();
+        counter.retain();
+        CHECK(!counter.is_unique());
+
+        CHECK(!counter.release());
+        CHECK(!counter.release());
+        CHECK(counter.is_unique());
+        CHECK(counter.release());
+    }
+
+    TEST_CASE_TEMPLATE("Exactly one thread releases the last reference", Counter,
+                       AtomicReferenceCounter, BiasedReferenceCounter) {
+        for (int round = 0; round < 200; ++round) {
+            Counter counter;
+            std::atomic<int> last_releases{0};
+            constexpr int kThreads = 4;
+            for (int i = 0; i < kThreads; ++i) {
+                counter.retain();
+            }
+
+            std::vector<std::thread> threads;
+            for (int i = 0; i < kThreads; ++i) {
+                threads.emplace_back([&] {
+                    // A reference retained by a non-owning thread, released together with the one it came from.
+                    counter.retain();
+                    last_releases += counter.release() ? 1 : 0;
+                    last_releases += counter.release() ? 1 : 0;
+                });
+            }
+            last_releases += counter.release() ? 1 : 0;
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            CHECK(last_releases == 1);
+        }
+    }
+
+    TEST_CASE_TEMPLATE("Arrays share storage across threads with a thread-safe counter", Counter,
+                       AtomicReferenceCounter, BiasedReferenceCounter) {
+        using SharedArray = Array<Int, DefaultAllocator, Counter>;
+        auto original = SharedArray::create_empty();
+        for (Int i = 0; i < 100; ++i) {
+            original.append(i);
+        }
+
+        std::vector<std::thread> threads;
+        std::vector<Int> sums(4);
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([copy = original, &sums, t]() mutable {
+                for (Int i = 0; i < copy.count(); ++i) {
+                    sums[t] += std::as_const(copy)[i];
+                }
+                copy.append(100);
+                sums[t] += std::as_const(copy)[100];
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        CHECK(original.is_uniquely_referenced());
+        CHECK(original.count() == 100);
+        for (auto sum : sums) {
+            CHECK(sum == 4950 + 100);
+        }
+    }
+}
+
+TEST_SUITE("SmallArray") {
+    TEST_CASE("A throwing copy destroys the elements copied so far") {
+        LifecycleTracker::reset();
+        {
+            auto inline_array = SmallArray<FallibleCopy, 4>::create_empty();
+            auto spilled = SmallArray<FallibleCopy, 4>::create_empty();
+            for (Int i = 0; i < 3; ++i) {
+                inline_array.emplace_back(i);
+            }
+            for (Int i = 0; i < 6; ++i) {
+                spilled.emplace_back(i);
+            }
+            const int live = LifecycleTracker::constructed - LifecycleTracker::destroyed;
+
+            for (const auto* source : {&inline_array, &spilled}) {
+                FallibleCopy::copies_left = 2;
+                bool caught = false;
+                try {
+                    const auto copy = *source;
+                } catch (const std::runtime_error&) {
+                    caught = true;
+                }
+                CHECK(caught);
+                CHECK(LifecycleTracker::constructed - LifecycleTracker::destroyed == live);
+            }
+        }
+        CHECK(LifecycleTracker::constructed == LifecycleTracker::destroyed);
+    }
+
+    TEST_CASE("Elements fit in the inline buffer without allocating") {
+        CountingAllocator::reset();
+        {
+            auto array = SmallArray<Int, 8, CountingAllocator>::create_empty();
+            CHECK(array.capacity() == 8);
+            for (Int i = 0; i < 8; ++i) {
+                array.append(i * 10);
+            }
+            CHECK(array.is_inline());
+            CHECK(array.count() == 8);
+            CHECK(array[7] == 70);
+        }
+        CHECK(CountingAllocator::allocations == 0);
+    }
+
+    TEST_CASE("Appending beyond the inline capacity spills to the heap") {
+        CountingAllocator::reset();
+        {
+            auto array = SmallArray<std::string, 2, CountingAllocator>::create_empty();
+            array.append(std::string(32, 'a'));
+            array.append(std::string(32, 'b'));
+            // The argument refers into the inline buffer that the elements leave.
+            array.emplace_back(array[0]);
+
+            CHECK(!array.is_inline());
+            CHECK(array.capacity() >= 3);
+            CHECK(array[0] == std::string(32, 'a'));
+            CHECK(array[1] == std::string(32, 'b'));
+            CHECK(array[2] == std::string(32, 'a'));
+
+            for (int i = 0; i < 100; ++i) {
+                array.append("x");
+            }
+            CHECK(array.count() == 103);
+        }
+        CHECK(CountingAllocator::allocations == CountingAllocator::deallocations);
+        CHECK(CountingAllocator::live_bytes == 0);
+    }
+
+    TEST_CASE("Reserving within the inline capacity does not allocate") {
+        auto array = SmallArray<Int, 4>::create_empty();
+        array.reserve(4);
+        CHECK(array.is_inline());
+
+        array.append(1);
+        array.reserve(16);
+        CHECK(!array.is_inline());
+        CHECK(array.capacity() == 16);
+        CHECK(array[0] == 1);
+    }
+
+    TEST_CASE("Moving and copying inline and spilled arrays") {
+        for (const Int count : {Int{3}, Int{20}}) {
+            auto array = SmallArray<std::string, 4>::create_empty();
+            for (Int i = 0; i < count; ++i) {
+                array.append(std::to_string(i));
+            }
+
+            auto copy = array;
+            CHECK(copy.count() == count);
+            CHECK(copy.is_inline() == array.is_inline());
+            copy[0] = "changed";
+            CHECK(array[0] == "0");
+
+            auto moved = std::move(array);
+            CHECK(array.count() == 0);
+            CHECK(moved.count() == count);
+            CHECK(moved[count - 1] == std::to_string(count - 1));
+
+            copy = std::move(moved);
+            CHECK(copy.count() == count);
+            CHECK(copy[0] == "0");
+        }
+    }
+
+    TEST_CASE("Elements are destroyed with the array") {
+        struct Tracked {
+            Tracked() { LifecycleTracker::constructed++; }
+            Tracked(const Tracked&) { LifecycleTracker::constructed++; }
+            Tracked(Tracked&&) noexcept { LifecycleTracker::constructed++; }
+            Tracked& operator=(Tracked&&) noexcept { return *this; }
+            ~Tracked() { LifecycleTracker::destroyed++; }
+        };
+
+        LifecycleTracker::reset();
+        {
+            auto small = SmallArray<Tracked, 4>::create_empty();
+            auto spilled = SmallArray<Tracked, 4>::create_empty();
+            for (int i = 0; i < 3; ++i) {
+                small.emplace_back();
+            }
+            for (int i = 0; i < 10; ++i) {
+                spilled.emplace_back();
+            }
+            auto copy = spilled;
+            small = std::move(spilled);
+            CHECK(small.count() == 10);
+        }
+        CHECK(LifecycleTracker::constructed == LifecycleTracker::destroyed);
     }
 }